@@ -4,9 +4,40 @@
 #include "Engine/Math/MathUtils.hpp"
 
 #include "Engine/Core/ByteBuffer.hpp"
+#include "Engine/Core/ByteSchema.hpp"
 
 #include <deque>
 
+
+// ===========================================================================================================
+// ===========================================================================================================
+template<>
+struct ByteSchema<Animation>
+{
+	static constexpr auto Fields()
+	{
+		return std::make_tuple(
+			SchemaMember("name", &Animation::m_name),
+			SchemaMember("ticks", &Animation::m_ticks),
+			SchemaMember("tps", &Animation::m_tps));
+	}
+};
+
+// header only, the key arrays are sized by the counts and stay hand-written
+template<>
+struct ByteSchema<AnimationCurve>
+{
+	static constexpr auto Fields()
+	{
+		return std::make_tuple(
+			SchemaTag("ACRV"),
+			SchemaTag("DATA"),
+			SchemaMember("numPosKeys", &AnimationCurve::m_numPosKeys),
+			SchemaMember("numRotKeys", &AnimationCurve::m_numRotKeys),
+			SchemaMember("numScaleKeys", &AnimationCurve::m_numScaleKeys));
+	}
+};
+
 AnimationCurve::AnimationCurve(int numPosKeys, int numRotKeys, int numScaleKeys)
 {
 	Initialize(numPosKeys, numRotKeys, numScaleKeys);
@@ -148,14 +179,9 @@ void AnimationCurve::ResolveAt(Vec3& pos, Quaternion& rot, Vec3& scale, float ti
 	}
 }
 
-void AnimationCurve::ReadBytes(ByteBuffer* byteBuf)
+void AnimationCurve::ReadBytes(ByteBufferView* byteBuf)
 {
-	char IDENTIFIER[4];
-	byteBuf->Read(4, &IDENTIFIER[0]); // should read "ACRV"
-	byteBuf->Read(4, &IDENTIFIER[0]); // should read "DATA"
-	byteBuf->Read(m_numPosKeys);
-	byteBuf->Read(m_numRotKeys);
-	byteBuf->Read(m_numScaleKeys);
+	SchemaRead(*this, byteBuf);
 
 	Initialize(m_numPosKeys, m_numRotKeys, m_numScaleKeys);
 	byteBuf->Read(m_numPosKeys, m_posTimes);
@@ -190,12 +216,7 @@ void AnimationCurve::ReadBytes(ByteBuffer* byteBuf)
 
 void AnimationCurve::WriteBytes(ByteBuffer* byteBuf) const
 {
-	byteBuf->Write(4, "ACRV");
-	byteBuf->Write(4, "DATA");
-//	size_t writeIdx = byteBuf->m_writeIdx;
-	byteBuf->Write(m_numPosKeys);
-	byteBuf->Write(m_numRotKeys);
-	byteBuf->Write(m_numScaleKeys);
+	SchemaWrite(*this, byteBuf);
 	byteBuf->Write(m_numPosKeys, m_posTimes);
 	byteBuf->Write(m_numRotKeys, m_rotTimes);
 	byteBuf->Write(m_numScaleKeys, m_scalingTimes);
@@ -232,7 +253,7 @@ AnimationFrame CurveAnimation::Sample(float time, const Pose& defaultPose) const
 	return frame;
 }
 
-void CurveAnimation::ReadBytes(ByteBuffer* byteBuf)
+void CurveAnimation::ReadBytes(ByteBufferView* byteBuf)
 {
 	char IDENTIFIER[4];
 	byteBuf->Read(4, &IDENTIFIER[0]); // should read "CURV"
@@ -302,11 +323,9 @@ void AnimationFrame::Apply(Pose& pose) const
 	}
 }
 
-void Animation::ReadBytes(ByteBuffer* byteBuf)
+void Animation::ReadBytes(ByteBufferView* byteBuf)
 {
-	ByteUtils::ReadString(byteBuf, m_name);
-	byteBuf->Read(m_ticks);
-	byteBuf->Read(m_tps);
+	SchemaRead(*this, byteBuf);
 
 // 	if (!ByteUtils::IsPlatformBigEndian())
 // 	{
@@ -317,10 +336,7 @@ void Animation::ReadBytes(ByteBuffer* byteBuf)
 
 void Animation::WriteBytes(ByteBuffer* byteBuf) const
 {
-	ByteUtils::WriteString(byteBuf, m_name);
-//	size_t writeIdx = byteBuf->m_writeIdx;
-	byteBuf->Write(m_ticks);
-	byteBuf->Write(m_tps);
+	SchemaWrite(*this, byteBuf);
 
 // 	if (!ByteUtils::IsPlatformBigEndian())
 // 	{
@@ -10,6 +10,7 @@
 // ===========================================================================================================
 // ===========================================================================================================
 class ByteBuffer;
+class ByteBufferView;
 class AnimationFrame;
 class CurveAnimation;
 typedef std::vector<AnimationFrame> FrameList;
@@ -41,7 +42,7 @@ public:
 	inline float GetDuration() const;
 
 	// Serialization
-	virtual void ReadBytes(ByteBuffer* byteBuf);
+	virtual void ReadBytes(ByteBufferView* byteBuf);
 	virtual void WriteBytes(ByteBuffer* byteBuf) const;
 
 public:
@@ -78,7 +79,7 @@ public:
 	void ResolveAt(Vec3& pos, Quaternion& rot, Vec3& scale, float tick) const;
 
 	// Serialization
-	void ReadBytes(ByteBuffer* byteBuf);
+	void ReadBytes(ByteBufferView* byteBuf);
 	void WriteBytes(ByteBuffer* byteBuf) const;
 
 public:
@@ -102,7 +103,7 @@ public:
 	AnimationFrame Sample(float time, const Pose& defaultPose) const override;
 
 	// Serialization
-	virtual void ReadBytes(ByteBuffer* byteBuf) override;
+	virtual void ReadBytes(ByteBufferView* byteBuf) override;
 	virtual void WriteBytes(ByteBuffer* byteBuf) const override;
 
 public:
@@ -83,9 +83,8 @@ const aiScene* AssetImporter::ImportFileFBX(size_t length, const char* data)
 
 const aiScene* AssetImporter::ImportFile(const char* path, const char* type)
 {
-	std::vector<uint8_t> buffer;
-	int size = FileReadToBuffer(buffer, path);
-	return size < 0 ? nullptr : ImportFile(buffer.size(), (char*)buffer.data(), type);
+	MappedFile file(path);
+	return file.IsOpen() ? ImportFile(file.GetSize(), (const char*)file.data(), type) : nullptr;
 }
 
 int AssetImporter::ParseMesh(const aiScene* pAIScene, std::vector<SkeletalMesh*>& meshes)
@@ -2,7 +2,7 @@
 
 #include "Engine/Core/ByteBuffer.hpp"
 
-void Mesh::ReadBytes(ByteBuffer* buffer)
+void Mesh::ReadBytes(ByteBufferView* buffer)
 {
 	ByteUtils::ReadString(buffer, m_name);
 
@@ -130,7 +130,7 @@ void Mesh::ReverseWindingOrder()
 	}
 }
 
-void StaticMesh::ReadBytes(ByteBuffer* byteBuf)
+void StaticMesh::ReadBytes(ByteBufferView* byteBuf)
 {
 	char IDENTIFIER[4];
 	byteBuf->Read(4, &IDENTIFIER[0]); // should read "STAT"
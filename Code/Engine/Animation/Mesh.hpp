@@ -10,6 +10,7 @@
 #define ENGINE_MESH_MAX_UVCHANNELS 8
 
 class ByteBuffer;
+class ByteBufferView;
 
 class Mesh
 {
@@ -20,7 +21,7 @@ protected:
 
 public:
 	// Serialization
-	virtual void ReadBytes(ByteBuffer* byteBuf);
+	virtual void ReadBytes(ByteBufferView* byteBuf);
 	virtual void WriteBytes(ByteBuffer* byteBuf) const;
 
 	virtual void TransformBasis(const Vec3& i, const Vec3& j, const Vec3& k);
@@ -46,7 +47,7 @@ protected:
 	virtual ~StaticMesh() {};
 
 	// Serialization
-	virtual void ReadBytes(ByteBuffer* byteBuf) override;
+	virtual void ReadBytes(ByteBufferView* byteBuf) override;
 	virtual void WriteBytes(ByteBuffer* byteBuf) const override;
 };
 
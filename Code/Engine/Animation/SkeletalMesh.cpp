@@ -3,7 +3,7 @@
 #include "Engine/Core/ByteBuffer.hpp"
 
 
-void SkeletalMesh::ReadBytes(ByteBuffer* byteBuf)
+void SkeletalMesh::ReadBytes(ByteBufferView* byteBuf)
 {
 	char IDENTIFIER[4];
 	byteBuf->Read(4, &IDENTIFIER[0]); // should read "SKEL"
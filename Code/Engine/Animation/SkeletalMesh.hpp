@@ -6,6 +6,7 @@
 #define ENGINE_SKEL_MAX_BONE_WEIGHTS 4
 
 class ByteBuffer;
+class ByteBufferView;
 
 struct BoneIndices
 {
@@ -27,7 +28,7 @@ public:
 	inline ~SkeletalMesh();
 
 	// Serialization
-	virtual void ReadBytes(ByteBuffer* byteBuf) override;
+	virtual void ReadBytes(ByteBufferView* byteBuf) override;
 	virtual void WriteBytes(ByteBuffer* byteBuf) const override;
 
 public:
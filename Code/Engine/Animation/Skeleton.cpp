@@ -1,6 +1,28 @@
 #include "Engine/Animation/Skeleton.hpp"
 
 #include "Engine/Core/ByteBuffer.hpp"
+#include "Engine/Core/ByteSchema.hpp"
+
+
+// ========================================================================================
+// ========================================================================================
+template<>
+struct ByteSchema<Bone>
+{
+	static constexpr auto Fields()
+	{
+		return std::make_tuple(
+			SchemaTag("BONE"),
+			SchemaTag("DATA"),
+			SchemaMember("name", &Bone::m_name),
+			SchemaMember("id", &Bone::m_id),
+			SchemaMember("parentId", &Bone::m_parentId),
+			SchemaMember("children", &Bone::m_children),
+			SchemaAlign(),
+			SchemaMember("transform", &Bone::m_transform),
+			SchemaMember("offset", &Bone::m_offset));
+	}
+};
 
 Skeleton::Skeleton()
 	: m_defaultPose(this)
@@ -61,7 +83,7 @@ const Bone* Skeleton::end() const
 	return &m_bones.data()[m_bones.size()];
 }
 
-void Skeleton::ReadBytes(ByteBuffer* byteBuf)
+void Skeleton::ReadBytes(ByteBufferView* byteBuf)
 {
 	char IDENTIFIER[4];
 	byteBuf->Read(4, &IDENTIFIER[0]); // should read "SKEL"
@@ -83,33 +105,14 @@ void Skeleton::WriteBytes(ByteBuffer* byteBuf) const
 	m_defaultPose.WriteBytes(byteBuf);
 }
 
-void Bone::ReadBytes(ByteBuffer* byteBuf)
+void Bone::ReadBytes(ByteBufferView* byteBuf)
 {
-	char IDENTIFIER[4];
-	byteBuf->Read(4, &IDENTIFIER[0]); // should read "BONE"
-	byteBuf->Read(4, &IDENTIFIER[0]); // should read "DATA"
-	ByteUtils::ReadString(byteBuf, m_name);
-	byteBuf->Read(m_id);
-	byteBuf->Read(m_parentId);
-	ByteUtils::ReadArray(byteBuf, m_children);
-	byteBuf->ReadAlignment();
-
-	byteBuf->Read(m_transform);
-	byteBuf->Read(m_offset);
+	SchemaRead(*this, byteBuf);
 }
 
 void Bone::WriteBytes(ByteBuffer* byteBuf) const
 {
-	byteBuf->Write(4, "BONE");
-	byteBuf->Write(4, "DATA");
-	ByteUtils::WriteString(byteBuf, m_name);
-	byteBuf->Write(m_id);
-	byteBuf->Write(m_parentId);
-	ByteUtils::WriteArray(byteBuf, m_children);
-	byteBuf->WriteAlignment();
-
-	byteBuf->Write(m_transform);
-	byteBuf->Write(m_offset);
+	SchemaWrite(*this, byteBuf);
 }
 
 Pose::Pose(const Skeleton* skeleton)
@@ -219,7 +222,7 @@ void Pose::BakeBoneLocalToComp(BoneId boneId, const Mat4x4& parentM)
 		BakeBoneLocalToComp(child, boneGlobalM);
 }
 
-void Pose::ReadBytes(ByteBuffer* byteBuf)
+void Pose::ReadBytes(ByteBufferView* byteBuf)
 {
 	m_boneLocalPose.resize(m_skeleton->size());
 	m_boneCompPose.resize(m_skeleton->size());
@@ -11,6 +11,7 @@ typedef unsigned char BoneId;
 constexpr BoneId INVALID_BONE_ID = 255;
 
 class ByteBuffer;
+class ByteBufferView;
 class Skeleton;
 
 
@@ -57,7 +58,7 @@ public:
 	void BakeBoneLocalToComp(BoneId boneId, const Mat4x4& parentM);
 
 	// Serialization
-	void ReadBytes(ByteBuffer* byteBuf);
+	void ReadBytes(ByteBufferView* byteBuf);
 	void WriteBytes(ByteBuffer* byteBuf) const;
 
 public:
@@ -81,7 +82,7 @@ public:
 	std::vector<BoneId> m_children;
 
 	// Serialization
-	void ReadBytes(ByteBuffer* byteBuf);
+	void ReadBytes(ByteBufferView* byteBuf);
 	void WriteBytes(ByteBuffer* byteBuf) const;
 };
 
@@ -110,7 +111,7 @@ public:
 	const Bone*             end() const;
 
 	// Serialization
-	void                    ReadBytes(ByteBuffer* byteBuf);
+	void                    ReadBytes(ByteBufferView* byteBuf);
 	void                    WriteBytes(ByteBuffer* byteBuf) const;
 
 private:
@@ -0,0 +1,207 @@
+#include "Engine/Core/BitBuffer.hpp"
+
+#include "Engine/Animation/Quaternion.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+
+#include <math.h>
+#include <string.h>
+
+
+// =============================================================================================
+// =============================================================================================
+static constexpr float SMALLEST_THREE_RANGE = 0.70710678f; // the three smaller components of a unit quaternion are within +-1/sqrt(2)
+
+static uint32_t QuantizeFloat(float value, float min, float max, int numBits)
+{
+	uint32_t maxQuantized = numBits < 32 ? (1u << numBits) - 1 : 0xFFFFFFFFu;
+	float fraction = (value - min) / (max - min);
+	if (!(fraction > 0.0f)) // NaN too
+		return 0;
+	if (fraction >= 1.0f)
+		return maxQuantized;
+	return (uint32_t)((double)fraction * maxQuantized + 0.5);
+}
+
+static float DequantizeFloat(uint32_t quantized, float min, float max, int numBits)
+{
+	uint32_t maxQuantized = numBits < 32 ? (1u << numBits) - 1 : 0xFFFFFFFFu;
+	return min + (float)((double)quantized / maxQuantized) * (max - min);
+}
+
+
+// =============================================================================================
+// =============================================================================================
+BitWriter::BitWriter(ByteBuffer* buffer)
+	: m_buffer(buffer)
+	, m_swapWords(ByteUtils::IsPlatformBigEndian())
+{
+}
+
+BitWriter::~BitWriter()
+{
+	Flush();
+}
+
+void BitWriter::WriteInt(int32_t value, int32_t min, int32_t max)
+{
+	ASSERT_OR_DIE(min <= value && value <= max, "BitWriter: WriteInt value out of range");
+	WriteBits((uint32_t)value - (uint32_t)min, BitUtils::GetNumBitsFor((uint32_t)max - (uint32_t)min));
+}
+
+void BitWriter::WriteVarInt(uint32_t value)
+{
+	while (value >= 0x80)
+	{
+		WriteBits((value & 0x7F) | 0x80, 8);
+		value >>= 7;
+	}
+	WriteBits(value, 8);
+}
+
+void BitWriter::WriteSignedVarInt(int32_t value)
+{
+	WriteVarInt(BitUtils::ZigZagEncode(value));
+}
+
+void BitWriter::WriteFloat(float value)
+{
+	uint32_t bits;
+	memcpy(&bits, &value, sizeof(bits));
+	WriteBits(bits, 32);
+}
+
+void BitWriter::WriteFloat(float value, float min, float max, int numBits)
+{
+	WriteBits(QuantizeFloat(value, min, max, numBits), numBits);
+}
+
+void BitWriter::WriteQuaternion(const Quaternion& rotation, int bitsPerComponent)
+{
+	float components[4] = { rotation.x, rotation.y, rotation.z, rotation.w };
+
+	int largest = 0;
+	for (int i = 1; i < 4; i++)
+	{
+		if (fabsf(components[i]) > fabsf(components[largest]))
+			largest = i;
+	}
+
+	// q and -q are the same rotation, flip so the dropped component is positive
+	float sign = components[largest] < 0.0f ? -1.0f : 1.0f;
+
+	WriteBits(largest, 2);
+	for (int i = 0; i < 4; i++)
+	{
+		if (i != largest)
+			WriteFloat(components[i] * sign, -SMALLEST_THREE_RANGE, SMALLEST_THREE_RANGE, bitsPerComponent);
+	}
+}
+
+void BitWriter::Flush()
+{
+	if (m_scratchBits == 0)
+		return;
+
+	uint32_t word = (uint32_t)m_scratch;
+	if (m_swapWords)
+		ByteUtils::ReverseBytes((int32_t&)word);
+	m_buffer->Write((m_scratchBits + 7) / 8, (const BYTE*)&word);
+
+	m_scratch = 0;
+	m_scratchBits = 0;
+}
+
+
+// =============================================================================================
+// =============================================================================================
+BitReader::BitReader(ByteBufferView* view)
+	: m_view(view)
+	, m_swapWords(ByteUtils::IsPlatformBigEndian())
+{
+}
+
+void BitReader::Refill()
+{
+	// the last word of a stream may be short, missing bytes stay zero
+	uint32_t word = 0;
+	size_t numBytes = m_view->Read(4, (BYTE*)&word);
+	if (m_swapWords)
+		ByteUtils::ReverseBytes((int32_t&)word);
+
+	m_scratch |= (uint64_t)word << m_scratchBits;
+	m_scratchBits += (int)numBytes * 8;
+}
+
+int32_t BitReader::ReadInt(int32_t min, int32_t max)
+{
+	uint32_t offset = ReadBits(BitUtils::GetNumBitsFor((uint32_t)max - (uint32_t)min));
+	if (offset > (uint32_t)max - (uint32_t)min)
+	{
+		m_overflowed = true;
+		return max;
+	}
+	return (int32_t)((uint32_t)min + offset);
+}
+
+uint32_t BitReader::ReadVarInt()
+{
+	uint32_t value = 0;
+	for (int shift = 0; shift < 35; shift += 7)
+	{
+		uint32_t group = ReadBits(8);
+		value |= (group & 0x7F) << shift;
+		if ((group & 0x80) == 0 || m_overflowed)
+			return value;
+	}
+
+	// more groups than a 32-bit value has, the stream is corrupt
+	m_overflowed = true;
+	return value;
+}
+
+int32_t BitReader::ReadSignedVarInt()
+{
+	return BitUtils::ZigZagDecode(ReadVarInt());
+}
+
+float BitReader::ReadFloat()
+{
+	uint32_t bits = ReadBits(32);
+	float value;
+	memcpy(&value, &bits, sizeof(value));
+	return value;
+}
+
+float BitReader::ReadFloat(float min, float max, int numBits)
+{
+	return DequantizeFloat(ReadBits(numBits), min, max, numBits);
+}
+
+Quaternion BitReader::ReadQuaternion(int bitsPerComponent)
+{
+	int largest = (int)ReadBits(2);
+
+	float components[4];
+	float sumSquared = 0.0f;
+	for (int i = 0; i < 4; i++)
+	{
+		if (i == largest)
+			continue;
+		components[i] = ReadFloat(-SMALLEST_THREE_RANGE, SMALLEST_THREE_RANGE, bitsPerComponent);
+		sumSquared += components[i] * components[i];
+	}
+	components[largest] = sumSquared < 1.0f ? sqrtf(1.0f - sumSquared) : 0.0f;
+
+	return Quaternion(components[0], components[1], components[2], components[3]);
+}
+
+void BitReader::Finish()
+{
+	// give back whole bytes that were fetched but not read, the partial one is the writer's padding
+	size_t unreadBytes = (size_t)m_scratchBits / 8;
+	m_view->m_readIdx -= unreadBytes;
+
+	m_scratch = 0;
+	m_scratchBits = 0;
+}
+
@@ -0,0 +1,162 @@
+#pragma once
+
+#include "Engine/Core/ByteBuffer.hpp"
+
+#include <cstdint>
+
+class Quaternion;
+
+
+// =============================================================================================
+// Bit packing on top of ByteBuffer, for replicated state that doesn't need whole bytes per field.
+// Bits gather in a 64-bit scratch word and go to the buffer 32 at a time, least significant bit
+// first, little-endian words on every platform. Flush writes the last partial word (rounded up to
+// whole bytes), after which plain ByteBuffer writes can follow again.
+// =============================================================================================
+class BitWriter
+{
+public:
+	explicit BitWriter(ByteBuffer* buffer);
+	~BitWriter(); // flushes
+
+	inline void WriteBits(uint32_t value, int numBits); // 0 to 32 bits, the low numBits of value
+	inline void WriteBool(bool value);
+	void        WriteInt(int32_t value, int32_t min, int32_t max); // just enough bits for the range
+	void        WriteVarInt(uint32_t value);       // 7 bits per group plus a continue bit
+	void        WriteSignedVarInt(int32_t value);  // zigzag, small magnitudes of either sign stay short
+	void        WriteFloat(float value);           // all 32 bits
+	void        WriteFloat(float value, float min, float max, int numBits); // clamped to the range
+	void        WriteQuaternion(const Quaternion& rotation, int bitsPerComponent = 10); // smallest three
+
+	void        Flush();
+	size_t      GetNumBitsWritten() const       { return m_numBitsWritten; }
+
+private:
+	inline void FlushWord();
+
+private:
+	ByteBuffer*  m_buffer = nullptr;
+	uint64_t     m_scratch = 0;
+	int          m_scratchBits = 0;
+	size_t       m_numBitsWritten = 0;
+	bool         m_swapWords = false; // big-endian platform
+};
+
+
+// =============================================================================================
+// Reads what BitWriter wrote. Words come from the view as they are needed; Finish hands the whole
+// bytes it fetched but didn't use back to the view, so reading can carry on byte-wise after the
+// bits. Reading past the end yields zeros and sets IsOverflowed instead of dying, since the bytes
+// usually come off the network.
+// =============================================================================================
+class BitReader
+{
+public:
+	explicit BitReader(ByteBufferView* view);
+
+	inline uint32_t ReadBits(int numBits);
+	inline bool     ReadBool();
+	int32_t         ReadInt(int32_t min, int32_t max);
+	uint32_t        ReadVarInt();
+	int32_t         ReadSignedVarInt();
+	float           ReadFloat();
+	float           ReadFloat(float min, float max, int numBits);
+	Quaternion      ReadQuaternion(int bitsPerComponent = 10);
+
+	void            Finish();
+	bool            IsOverflowed() const        { return m_overflowed; }
+
+private:
+	void            Refill();
+
+private:
+	ByteBufferView*  m_view = nullptr;
+	uint64_t         m_scratch = 0;
+	int              m_scratchBits = 0;
+	bool             m_overflowed = false;
+	bool             m_swapWords = false;
+};
+
+
+// =============================================================================================
+// =================================   INLINE FUNCTIONS   ======================================
+// =============================================================================================
+namespace BitUtils
+{
+	// number of bits to hold values 0..maxValue
+	inline int GetNumBitsFor(uint32_t maxValue)
+	{
+		int numBits = 0;
+		while (maxValue)
+		{
+			numBits++;
+			maxValue >>= 1;
+		}
+		return numBits;
+	}
+
+	inline uint32_t ZigZagEncode(int32_t value)
+	{
+		return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+	}
+
+	inline int32_t ZigZagDecode(uint32_t value)
+	{
+		return (int32_t)(value >> 1) ^ -(int32_t)(value & 1);
+	}
+}
+
+void BitWriter::WriteBits(uint32_t value, int numBits)
+{
+	if (numBits < 32)
+		value &= (1u << numBits) - 1;
+
+	m_scratch |= (uint64_t)value << m_scratchBits;
+	m_scratchBits += numBits;
+	m_numBitsWritten += numBits;
+	if (m_scratchBits >= 32)
+		FlushWord();
+}
+
+void BitWriter::WriteBool(bool value)
+{
+	WriteBits(value ? 1 : 0, 1);
+}
+
+void BitWriter::FlushWord()
+{
+	uint32_t word = (uint32_t)m_scratch;
+	if (m_swapWords)
+		ByteUtils::ReverseBytes((int32_t&)word);
+	m_buffer->Write(word);
+
+	m_scratch >>= 32;
+	m_scratchBits -= 32;
+}
+
+uint32_t BitReader::ReadBits(int numBits)
+{
+	if (m_scratchBits < numBits)
+		Refill();
+
+	uint64_t mask = ((uint64_t)1 << numBits) - 1;
+	uint32_t value = (uint32_t)(m_scratch & mask);
+	if (m_scratchBits < numBits)
+	{
+		// out of bytes, the missing high bits read as zeros
+		m_overflowed = true;
+		m_scratch = 0;
+		m_scratchBits = 0;
+		return value;
+	}
+
+	m_scratch >>= numBits;
+	m_scratchBits -= numBits;
+	return value;
+}
+
+bool BitReader::ReadBool()
+{
+	return ReadBits(1) != 0;
+}
+
@@ -1,9 +1,42 @@
 #include "Engine/Core/BufferCoder.hpp"
 
+#include <cstddef>
+
+
+// the span codecs copy these as arrays of 4 byte scalars
+static_assert(sizeof(Vec2) == 8 && sizeof(Vec3) == 12 && sizeof(Vec4) == 16, "BufferCoder: Vec layout");
+static_assert(sizeof(IntVec2) == 8 && sizeof(IntVec3) == 12, "BufferCoder: IntVec layout");
+static_assert(sizeof(AABB2) == 16 && sizeof(AABB3) == 24, "BufferCoder: AABB layout");
+static_assert(sizeof(Vertex_PCU) == 24 && offsetof(Vertex_PCU, m_color) == 12, "BufferCoder: Vertex_PCU layout");
+
+// whole values only: a span cut short by the end of the buffer stops after the last complete one
+template<typename T>
+static size_t ReadScalars32(IOBuffer& buffer, size_t count, T* dst)
+{
+    size_t available = buffer.m_buffer.GetReadableSize() / sizeof(T);
+    if (count > available)
+        count = available;
+    return buffer.readArray(count * (sizeof(T) / 4), dst, 4) / (sizeof(T) / 4);
+}
+
+template<typename T>
+static void WriteScalars32(IOBuffer& buffer, size_t count, const T* src)
+{
+    buffer.writeArray(count * (sizeof(T) / 4), src, 4);
+}
+
+// Vertex_PCU is all floats but the color, whose bytes never flip; swapping every word and
+// turning the color words back is still much cheaper than going field by field
+static void UnflipColors(BYTE* vertices, size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+        ByteUtils::ReverseBytes32(&vertices[i * sizeof(Vertex_PCU) + offsetof(Vertex_PCU, m_color)]);
+}
+
 
 std::string BufferCoder::ReadCString(IOBuffer& buffer)
 {
-    std::string str = std::string((const char*)buffer.m_buffer.data()[buffer.m_buffer.m_readIdx]);
+    std::string str = std::string((const char*)&buffer.m_buffer.data()[buffer.m_buffer.m_readIdx]);
     buffer.skip(str.size() + 1);
     return str;
 }
@@ -19,32 +52,51 @@ std::string BufferCoder::ReadString(IOBuffer& buffer)
 
 Vec2 BufferCoder::ReadVec2(IOBuffer& buffer)
 {
-    return Vec2(buffer.ReadFloat(), buffer.ReadFloat());
+    // one statement per component, argument evaluation order is unspecified
+    float x = buffer.ReadFloat();
+    float y = buffer.ReadFloat();
+    return Vec2(x, y);
 }
 
 Vec3 BufferCoder::ReadVec3(IOBuffer& buffer)
 {
-    return Vec3(buffer.ReadFloat(), buffer.ReadFloat(), buffer.ReadFloat());
+    float x = buffer.ReadFloat();
+    float y = buffer.ReadFloat();
+    float z = buffer.ReadFloat();
+    return Vec3(x, y, z);
 }
 
 Vec4 BufferCoder::ReadVec4(IOBuffer& buffer)
 {
-    return Vec4(buffer.ReadFloat(), buffer.ReadFloat(), buffer.ReadFloat(), buffer.ReadFloat());
+    float x = buffer.ReadFloat();
+    float y = buffer.ReadFloat();
+    float z = buffer.ReadFloat();
+    float w = buffer.ReadFloat();
+    return Vec4(x, y, z, w);
 }
 
 IntVec2 BufferCoder::ReadIntVec2(IOBuffer& buffer)
 {
-    return IntVec2(buffer.ReadInt(), buffer.ReadInt());
+    int x = buffer.ReadInt();
+    int y = buffer.ReadInt();
+    return IntVec2(x, y);
 }
 
 IntVec3 BufferCoder::ReadIntVec3(IOBuffer& buffer)
 {
-    return IntVec3(buffer.ReadInt(), buffer.ReadInt(), buffer.ReadInt());
+    int x = buffer.ReadInt();
+    int y = buffer.ReadInt();
+    int z = buffer.ReadInt();
+    return IntVec3(x, y, z);
 }
 
 Rgba8 BufferCoder::ReadRgba8(IOBuffer& buffer)
 {
-    return Rgba8(buffer.ReadByte(), buffer.ReadByte(), buffer.ReadByte(), buffer.ReadByte());
+    BYTE r = buffer.ReadByte();
+    BYTE g = buffer.ReadByte();
+    BYTE b = buffer.ReadByte();
+    BYTE a = buffer.ReadByte();
+    return Rgba8(r, g, b, a);
 }
 
 AABB2 BufferCoder::ReadAABB2(IOBuffer& buffer)
@@ -156,3 +208,88 @@ void BufferCoder::Write(IOBuffer& buffer, const Vertex_PCU& val)
     Write(buffer, val.m_color);
     Write(buffer, val.m_uvTexCoords);
 }
+
+size_t BufferCoder::Read(IOBuffer& buffer, size_t count, Vec2* dst)
+{
+    return ReadScalars32(buffer, count, dst);
+}
+
+size_t BufferCoder::Read(IOBuffer& buffer, size_t count, Vec3* dst)
+{
+    return ReadScalars32(buffer, count, dst);
+}
+
+size_t BufferCoder::Read(IOBuffer& buffer, size_t count, Vec4* dst)
+{
+    return ReadScalars32(buffer, count, dst);
+}
+
+size_t BufferCoder::Read(IOBuffer& buffer, size_t count, IntVec2* dst)
+{
+    return ReadScalars32(buffer, count, dst);
+}
+
+size_t BufferCoder::Read(IOBuffer& buffer, size_t count, IntVec3* dst)
+{
+    return ReadScalars32(buffer, count, dst);
+}
+
+size_t BufferCoder::Read(IOBuffer& buffer, size_t count, AABB2* dst)
+{
+    return ReadScalars32(buffer, count, dst);
+}
+
+size_t BufferCoder::Read(IOBuffer& buffer, size_t count, AABB3* dst)
+{
+    return ReadScalars32(buffer, count, dst);
+}
+
+size_t BufferCoder::Read(IOBuffer& buffer, size_t count, Vertex_PCU* dst)
+{
+    size_t numRead = ReadScalars32(buffer, count, dst);
+    if (buffer.isFlippingEndian())
+        UnflipColors((BYTE*)dst, numRead); // the rest of dst was never written
+    return numRead;
+}
+
+void BufferCoder::Write(IOBuffer& buffer, size_t count, const Vec2* src)
+{
+    WriteScalars32(buffer, count, src);
+}
+
+void BufferCoder::Write(IOBuffer& buffer, size_t count, const Vec3* src)
+{
+    WriteScalars32(buffer, count, src);
+}
+
+void BufferCoder::Write(IOBuffer& buffer, size_t count, const Vec4* src)
+{
+    WriteScalars32(buffer, count, src);
+}
+
+void BufferCoder::Write(IOBuffer& buffer, size_t count, const IntVec2* src)
+{
+    WriteScalars32(buffer, count, src);
+}
+
+void BufferCoder::Write(IOBuffer& buffer, size_t count, const IntVec3* src)
+{
+    WriteScalars32(buffer, count, src);
+}
+
+void BufferCoder::Write(IOBuffer& buffer, size_t count, const AABB2* src)
+{
+    WriteScalars32(buffer, count, src);
+}
+
+void BufferCoder::Write(IOBuffer& buffer, size_t count, const AABB3* src)
+{
+    WriteScalars32(buffer, count, src);
+}
+
+void BufferCoder::Write(IOBuffer& buffer, size_t count, const Vertex_PCU* src)
+{
+    WriteScalars32(buffer, count, src);
+    if (buffer.isFlippingEndian())
+        UnflipColors(&buffer.m_buffer.data()[buffer.m_buffer.m_writeIdx - count * sizeof(Vertex_PCU)], count);
+}
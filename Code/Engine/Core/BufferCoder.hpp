@@ -41,5 +41,26 @@ public:
     void              Write(IOBuffer& buffer, const AABB2& val);
     void              Write(IOBuffer& buffer, const AABB3& val);
     void              Write(IOBuffer& buffer, const Vertex_PCU& val);
+
+    // Spans of count values, the same bytes as count single calls but one copy (or one vectorized
+    // swap when the buffer flips endianness) for the whole span. The reads return how many values
+    // they read, fewer than count when the buffer runs out
+    size_t            Read(IOBuffer& buffer, size_t count, Vec2* dst);
+    size_t            Read(IOBuffer& buffer, size_t count, Vec3* dst);
+    size_t            Read(IOBuffer& buffer, size_t count, Vec4* dst);
+    size_t            Read(IOBuffer& buffer, size_t count, IntVec2* dst);
+    size_t            Read(IOBuffer& buffer, size_t count, IntVec3* dst);
+    size_t            Read(IOBuffer& buffer, size_t count, AABB2* dst);
+    size_t            Read(IOBuffer& buffer, size_t count, AABB3* dst);
+    size_t            Read(IOBuffer& buffer, size_t count, Vertex_PCU* dst);
+
+    void              Write(IOBuffer& buffer, size_t count, const Vec2* src);
+    void              Write(IOBuffer& buffer, size_t count, const Vec3* src);
+    void              Write(IOBuffer& buffer, size_t count, const Vec4* src);
+    void              Write(IOBuffer& buffer, size_t count, const IntVec2* src);
+    void              Write(IOBuffer& buffer, size_t count, const IntVec3* src);
+    void              Write(IOBuffer& buffer, size_t count, const AABB2* src);
+    void              Write(IOBuffer& buffer, size_t count, const AABB3* src);
+    void              Write(IOBuffer& buffer, size_t count, const Vertex_PCU* src);
 };
 
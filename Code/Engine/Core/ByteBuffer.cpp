@@ -1,93 +1,438 @@
 #include "Engine/Core/ByteBuffer.hpp"
 
+#include "Engine/Core/ErrorWarningAssert.hpp"
+
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define BYTEUTILS_TARGET(isa)
+#else
+#define BYTEUTILS_TARGET(isa) __attribute__((target(isa)))
+#endif
+
+
+// =============================================================================================
+// Byte swap kernels
+// =============================================================================================
+enum class SimdLevel
+{
+	SCALAR,
+	SSSE3,
+	AVX2,
+};
+
+static SimdLevel DetectSimdLevel()
+{
+#if defined(_MSC_VER)
+	int info[4];
+	__cpuid(info, 0);
+	int maxLeaf = info[0];
+	__cpuid(info, 1);
+	bool ssse3 = (info[2] & (1 << 9)) != 0;
+	bool avx = (info[2] & (1 << 27)) && (info[2] & (1 << 28)) && (_xgetbv(0) & 6) == 6; // and the os saves ymm
+	bool avx2 = false;
+	if (avx && maxLeaf >= 7)
+	{
+		__cpuidex(info, 7, 0);
+		avx2 = (info[1] & (1 << 5)) != 0;
+	}
+#else
+	__builtin_cpu_init();
+	bool ssse3 = __builtin_cpu_supports("ssse3");
+	bool avx2 = __builtin_cpu_supports("avx2");
+#endif
+	return avx2 ? SimdLevel::AVX2 : (ssse3 ? SimdLevel::SSSE3 : SimdLevel::SCALAR);
+}
+
+static const SimdLevel s_simdLevel = DetectSimdLevel();
+
+// pshufb masks reversing each 2, 4 and 8 byte element of a 16 byte lane
+alignas(16) static const BYTE SWAP_MASKS[3][16] =
+{
+	{ 1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14 },
+	{ 3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12 },
+	{ 7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8 },
+};
+
+// each kernel returns how many bytes it did, the caller finishes the tail
+BYTEUTILS_TARGET("ssse3")
+static size_t CopyReverseBytes_SSSE3(BYTE* dst, const BYTE* src, size_t size, const BYTE* swapMask)
+{
+	__m128i mask = _mm_load_si128((const __m128i*)swapMask);
+	size_t idx = 0;
+	for (; idx + 16 <= size; idx += 16)
+	{
+		__m128i bytes = _mm_loadu_si128((const __m128i*)&src[idx]);
+		_mm_storeu_si128((__m128i*)&dst[idx], _mm_shuffle_epi8(bytes, mask));
+	}
+	return idx;
+}
+
+BYTEUTILS_TARGET("avx2")
+static size_t CopyReverseBytes_AVX2(BYTE* dst, const BYTE* src, size_t size, const BYTE* swapMask)
+{
+	__m256i mask = _mm256_broadcastsi128_si256(_mm_load_si128((const __m128i*)swapMask));
+	size_t idx = 0;
+	for (; idx + 64 <= size; idx += 64)
+	{
+		__m256i bytes0 = _mm256_loadu_si256((const __m256i*)&src[idx]);
+		__m256i bytes1 = _mm256_loadu_si256((const __m256i*)&src[idx + 32]);
+		_mm256_storeu_si256((__m256i*)&dst[idx], _mm256_shuffle_epi8(bytes0, mask));
+		_mm256_storeu_si256((__m256i*)&dst[idx + 32], _mm256_shuffle_epi8(bytes1, mask));
+	}
+	for (; idx + 32 <= size; idx += 32)
+	{
+		__m256i bytes = _mm256_loadu_si256((const __m256i*)&src[idx]);
+		_mm256_storeu_si256((__m256i*)&dst[idx], _mm256_shuffle_epi8(bytes, mask));
+	}
+	return idx;
+}
+
+
+ByteBufferView::ByteBufferView(const void* data, size_t size)
+	: m_viewData((const BYTE*)data)
+	, m_writeIdx(size)
+{
+}
+
+size_t ByteBufferView::Skip(size_t size)
+{
+	if (m_readIdx + size > m_writeIdx)
+		size = m_writeIdx - m_readIdx;
+
+	m_readIdx += size;
+	return size;
+}
+
+size_t ByteBufferView::ReadAlignment()
+{
+	size_t size = 0;
+	BYTE b;
+	while (m_readIdx % 4 != 0)
+		size += Read(b);
+	return size;
+}
+
+const BYTE* ByteBufferView::data() const
+{
+	return m_viewData;
+}
+
+void ByteBufferView::ResetRead()
+{
+	m_readIdx = 0;
+}
+
+bool ByteBufferView::IsReadable(size_t size) const
+{
+	return (m_readIdx + size) <= m_writeIdx;
+}
+
+size_t ByteBufferView::GetReadableSize() const
+{
+	return m_writeIdx - m_readIdx;
+}
+
+ByteBufferView ByteBufferView::Slice(size_t offset /*= 0*/, size_t length /*= -1*/) const
+{
+	size_t readable = GetReadableSize();
+	if (offset > readable)
+		offset = readable;
+	if (length > readable - offset)
+		length = readable - offset;
+
+	return ByteBufferView(&m_viewData[m_readIdx + offset], length);
+}
 
-ByteBuffer::ByteBuffer(size_t initialCapacity /*= 0*/) : m_data(initialCapacity)
+ByteBufferView ByteBufferView::ReadSlice(size_t length)
 {
+	ByteBufferView slice = Slice(0, length);
+	m_readIdx += slice.m_writeIdx;
+	return slice;
+}
+
+ByteBuffer::ByteBuffer(size_t initialCapacity /*= 0*/)
+{
+	Reserve(initialCapacity);
+}
 
+ByteBuffer::ByteBuffer(const ByteBuffer& copyFrom)
+	: ByteBufferView()
+{
+	*this = copyFrom;
+}
+
+ByteBuffer::ByteBuffer(const ByteBuffer& copyFrom, size_t offset, size_t length /*= -1*/)
+	: ByteBuffer(copyFrom.Slice(offset, length))
+{
 }
 
-ByteBuffer::ByteBuffer(const ByteBuffer& copyFrom, size_t offset /*= 0*/, size_t length /*= -1*/)
+ByteBuffer::ByteBuffer(ByteBuffer&& moveFrom) noexcept
+	: ByteBufferView()
 {
-	if (length == -1)
-		length = copyFrom.m_writeIdx - copyFrom.m_readIdx + offset;
+	*this = std::move(moveFrom);
+}
 
-	m_data.resize(length);
-	memcpy(m_data.data(), &copyFrom.m_data[copyFrom.m_readIdx + offset], length);
+ByteBuffer::ByteBuffer(const ByteBufferView& copyFrom)
+{
+	size_t length = copyFrom.GetReadableSize();
+	Reserve(length);
+	if (length)
+		memcpy(m_data.get(), &copyFrom.data()[copyFrom.m_readIdx], length);
+	m_writeIdx = length;
 }
 
 ByteBuffer::~ByteBuffer()
 {
 }
 
-size_t ByteBuffer::WriteZero(size_t size)
+ByteBuffer& ByteBuffer::operator=(const ByteBuffer& copyFrom)
 {
-	if (m_data.size() < m_writeIdx + size)
-		m_data.resize(m_writeIdx + size);
+	if (this != &copyFrom)
+	{
+		m_segments.clear();
+		for (const Segment& segment : copyFrom.m_segments)
+		{
+			size_t length = segment.m_end - segment.m_begin;
+			Segment copy = { std::unique_ptr<BYTE[]>(new BYTE[length]), 0, length };
+			memcpy(copy.m_data.get(), &segment.m_data[segment.m_begin], length);
+			m_segments.push_back(std::move(copy));
+		}
+		m_segmentSize = copyFrom.m_segmentSize;
+		m_sealedIdx = copyFrom.m_sealedIdx;
+
+		m_readIdx = m_writeIdx = 0;
+		if (m_capacity < copyFrom.m_writeIdx)
+			Reallocate(copyFrom.m_writeIdx);
+		if (copyFrom.m_writeIdx)
+			memcpy(m_data.get(), copyFrom.m_data.get(), copyFrom.m_writeIdx);
+		m_readIdx = copyFrom.m_readIdx;
+		m_writeIdx = copyFrom.m_writeIdx;
+	}
+	return *this;
+}
+
+ByteBuffer& ByteBuffer::operator=(ByteBuffer&& moveFrom) noexcept
+{
+	if (this != &moveFrom)
+	{
+		m_data = std::move(moveFrom.m_data);
+		m_viewData = moveFrom.m_viewData;
+		m_capacity = moveFrom.m_capacity;
+		m_segmentSize = moveFrom.m_segmentSize;
+		m_sealedIdx = moveFrom.m_sealedIdx;
+		m_segments = std::move(moveFrom.m_segments);
+		m_readIdx = moveFrom.m_readIdx;
+		m_writeIdx = moveFrom.m_writeIdx;
+
+		// left empty, and still usable
+		moveFrom.m_viewData = nullptr;
+		moveFrom.m_capacity = 0;
+		moveFrom.m_sealedIdx = 0;
+		moveFrom.m_segments.clear();
+		moveFrom.m_readIdx = moveFrom.m_writeIdx = 0;
+	}
+	return *this;
+}
+
+void ByteBuffer::Grow(size_t appendSize)
+{
+	if (m_segmentSize && m_writeIdx > 0)
+	{
+		// hand the filled block over as it is and start a new one, nothing gets copied
+		m_segments.push_back({ std::move(m_data), m_readIdx, m_writeIdx });
+		m_sealedIdx += m_writeIdx;
+		m_readIdx = m_writeIdx = 0;
+		m_capacity = 0;
+		Reallocate(m_segmentSize > appendSize ? m_segmentSize : appendSize);
+		return;
+	}
 
-	memset(&m_data[m_writeIdx], 0, size);
-	m_writeIdx += size;
-	return size;
+	// geometric, a run of small writes costs amortized O(1) each
+	size_t capacity = m_capacity * 2;
+	if (capacity < 64)
+		capacity = 64;
+	if (capacity < m_writeIdx + appendSize)
+		capacity = m_writeIdx + appendSize;
+	Reallocate(capacity);
 }
 
-size_t ByteBuffer::Skip(size_t size)
+void ByteBuffer::Reallocate(size_t capacity)
 {
-	if (m_readIdx + size > m_writeIdx)
-		size = m_writeIdx - m_readIdx;
+	// not value-initialized, bytes past the write index are garbage until written
+	BYTE* data = new BYTE[capacity];
+	if (m_writeIdx)
+		memcpy(data, m_data.get(), m_writeIdx);
 
-	m_readIdx += size;
+	m_data.reset(data);
+	m_capacity = capacity;
+	m_viewData = data;
+}
+
+void ByteBuffer::Reserve(size_t capacity)
+{
+	if (m_capacity < capacity)
+		Reallocate(capacity);
+}
+
+size_t ByteBuffer::GetCapacity() const
+{
+	return m_capacity;
+}
+
+void ByteBuffer::SetSegmentSize(size_t segmentSize)
+{
+	m_segmentSize = segmentSize;
+}
+
+size_t ByteBuffer::GetTotalSize() const
+{
+	size_t size = GetReadableSize();
+	for (const Segment& segment : m_segments)
+		size += segment.m_end - segment.m_begin;
 	return size;
 }
 
-size_t ByteBuffer::WriteAlignment()
+std::vector<ByteBufferView> ByteBuffer::GetSegments() const
 {
-	size_t size = 0;
-	BYTE b = 0;
-	while (m_writeIdx % 4 != 0)
-		size += Write(b);
+	std::vector<ByteBufferView> segments;
+	segments.reserve(m_segments.size() + 1);
+	for (const Segment& segment : m_segments)
+		segments.emplace_back(&segment.m_data[segment.m_begin], segment.m_end - segment.m_begin);
+	segments.push_back(Slice());
+	return segments;
+}
+
+void ByteBuffer::ReleaseSegments()
+{
+	m_segments.clear();
+}
+
+size_t ByteBuffer::WriteZero(size_t size)
+{
+	if (!size)
+		return 0;
+
+	if (m_capacity < m_writeIdx + size)
+		Grow(size);
+
+	memset(&m_data[m_writeIdx], 0, size);
+	m_writeIdx += size;
 	return size;
 }
 
-size_t ByteBuffer::ReadAlignment()
+size_t ByteBuffer::WriteAlignment()
 {
+	// relative to the start of the whole output, segments don't end aligned
 	size_t size = 0;
-	BYTE b;
-	while (m_readIdx % 4 != 0)
-		size += Read(b);
+	BYTE b = 0;
+	while ((m_sealedIdx + m_writeIdx) % 4 != 0)
+		size += Write(b);
 	return size;
 }
 
 BYTE* ByteBuffer::data()
 {
-	return m_data.data();
+	return m_data.get();
 }
 
 void ByteBuffer::Reset()
 {
 	m_readIdx = m_writeIdx = 0;
-}
-
-void ByteBuffer::ResetRead()
-{
-	m_readIdx = 0;
+	m_sealedIdx = 0;
+	m_segments.clear();
 }
 
 void ByteBuffer::ShrinkBuffer()
 {
 	size_t length = m_writeIdx - m_readIdx;
-	memmove(data(), &data()[m_readIdx], length);
+	if (length)
+		memmove(data(), &data()[m_readIdx], length);
 	m_readIdx = 0;
 	m_writeIdx = length;
 }
 
-bool ByteBuffer::IsReadable(size_t size)
+void ByteBuffer::EnsureWritable(size_t size)
 {
-	return (m_readIdx + size) <= m_writeIdx;
+	if (m_capacity < m_writeIdx + size)
+		Grow(size);
 }
 
-void ByteBuffer::EnsureWritable(size_t size)
+void ByteUtils::ReverseBytesArray(void* data, size_t count, int width)
 {
-	if (m_data.size() < m_writeIdx + size)
-		m_data.resize(m_writeIdx + size);
+	CopyReverseBytes(data, data, count, width);
+}
+
+void ByteUtils::CopyReverseBytes(void* dst, const void* src, size_t count, int width)
+{
+	BYTE* dstBytes = (BYTE*)dst;
+	const BYTE* srcBytes = (const BYTE*)src;
+	size_t size = count * width;
+
+	int maskIdx = width == 2 ? 0 : (width == 4 ? 1 : (width == 8 ? 2 : -1));
+	if (maskIdx < 0)
+	{
+		// single bytes, nothing to flip
+		if (dst != src && size)
+			memcpy(dst, src, size);
+		return;
+	}
+
+	size_t done = 0;
+	if (s_simdLevel == SimdLevel::AVX2)
+		done = CopyReverseBytes_AVX2(dstBytes, srcBytes, size, SWAP_MASKS[maskIdx]);
+	if (s_simdLevel >= SimdLevel::SSSE3)
+		done += CopyReverseBytes_SSSE3(&dstBytes[done], &srcBytes[done], size - done, SWAP_MASKS[maskIdx]);
+
+	// whole elements are left, the kernels only take multiples of 16 bytes
+	for (size_t idx = done; idx < size; idx += width)
+	{
+		BYTE element[8];
+		memcpy(element, &srcBytes[idx], width);
+		for (int i = 0; i < width; i++)
+			dstBytes[idx + i] = element[width - 1 - i];
+	}
+}
+
+size_t ByteUtils::ReadSwapped(ByteBufferView* buffer, size_t size, void* dst, DataType type)
+{
+	if (IsPlatformBigEndian())
+		return buffer->Read(size, (BYTE*)dst);
+
+	if (size > buffer->GetReadableSize())
+		size = buffer->GetReadableSize();
+
+	int width = (int)type & 0xFFFF;
+	size_t count = size / width;
+	const BYTE* src = &buffer->data()[buffer->m_readIdx];
+	CopyReverseBytes(dst, src, count, width);
+	if (size > count * width)
+		memcpy(&((BYTE*)dst)[count * width], &src[count * width], size - count * width);
+
+	buffer->m_readIdx += size;
+	return size;
+}
+
+size_t ByteUtils::WriteSwapped(ByteBuffer* buffer, size_t size, const void* src, DataType type)
+{
+	if (IsPlatformBigEndian())
+		return buffer->Write(size, (const BYTE*)src);
+
+	if (!size)
+		return 0;
+
+	// one contiguous block, also in segmented mode
+	buffer->EnsureWritable(size);
+
+	int width = (int)type & 0xFFFF;
+	size_t count = size / width;
+	BYTE* dst = &buffer->data()[buffer->m_writeIdx];
+	CopyReverseBytes(dst, src, count, width);
+	if (size > count * width)
+		memcpy(&dst[count * width], &((const BYTE*)src)[count * width], size - count * width);
+
+	buffer->m_writeIdx += size;
+	return size;
 }
 
 bool ByteUtils::IsPlatformBigEndian()
@@ -173,7 +518,7 @@ void ByteUtils::ReverseBytes64(BYTE* ptr)
 		ptr[i] = ch[i];
 }
 
-void ByteUtils::ReadString(ByteBuffer* buffer, std::string& val)
+void ByteUtils::ReadString(ByteBufferView* buffer, std::string& val)
 {
 	buffer->ReadAlignment();
 	size_t size;
@@ -198,7 +543,7 @@ void ByteUtils::WriteString(ByteBuffer* buffer, const char* data)
 	WriteString(buffer, std::string(data));
 }
 
-void ByteUtils::ReadString_Net(ByteBuffer* buffer, std::string& val)
+void ByteUtils::ReadString_Net(ByteBufferView* buffer, std::string& val)
 {
 	buffer->ReadAlignment();
 	size_t size;
@@ -228,7 +573,7 @@ void ByteUtils::WriteString_Net(ByteBuffer* buffer, const char* data)
 	WriteString_Net(buffer, std::string(data));
 }
 
-void ByteUtils::ReadVarInt(ByteBuffer* buffer, int& val)
+void ByteUtils::ReadVarInt(ByteBufferView* buffer, int& val)
 {
 	constexpr unsigned char mask = 1 << 7;
 	val = 0;
@@ -258,22 +603,36 @@ void ByteUtils::WriteVarInt(ByteBuffer* buffer, int val)
 }
 
 NetworkBuffer::NetworkBuffer(ByteBuffer* buffer)
-	: m_buffer(buffer)
+	: m_view(buffer)
+	, m_buffer(buffer)
 	, m_transEndian(!ByteUtils::IsPlatformBigEndian())
 {
 }
 
+NetworkBuffer::NetworkBuffer(ByteBufferView* view)
+	: m_view(view)
+	, m_buffer(nullptr)
+	, m_transEndian(!ByteUtils::IsPlatformBigEndian())
+{
+}
+
+ByteBuffer* NetworkBuffer::GetWriteBuffer()
+{
+	GUARANTEE_OR_DIE(m_buffer, "NetworkBuffer: writing to a read only view");
+	return m_buffer;
+}
+
 BYTE NetworkBuffer::ReadByte()
 {
 	BYTE b;
-	m_buffer->Read(b);
+	m_view->Read(b);
 	return b;
 }
 
 int32_t NetworkBuffer::ReadInt()
 {
 	int32_t i;
-	m_buffer->Read(i);
+	m_view->Read(i);
 	if (m_transEndian)
 		ByteUtils::ReverseBytes(i);
 	return i;
@@ -315,13 +674,14 @@ size_t NetworkBuffer::ReadSize64()
 
 void NetworkBuffer::WriteByte(BYTE val)
 {
-	m_buffer->Write(val);
+	GetWriteBuffer()->Write(val);
 }
 
 void NetworkBuffer::WriteInt(int32_t val)
 {
-	ByteUtils::ReverseBytes(val);
-	m_buffer->Write(val);
+	if (m_transEndian)
+		ByteUtils::ReverseBytes(val);
+	GetWriteBuffer()->Write(val);
 }
 
 void NetworkBuffer::WriteUInt(uint32_t val)
@@ -343,7 +703,7 @@ void NetworkBuffer::WriteLong(int64_t val)
 {
 	if (m_transEndian)
 		ByteUtils::ReverseBytes(val);
-	m_buffer->Write(val);
+	GetWriteBuffer()->Write(val);
 }
 
 void NetworkBuffer::WriteULong(uint64_t val)
@@ -361,19 +721,19 @@ void NetworkBuffer::WriteSize64(size_t val)
 	WriteLong((int64_t&)val);
 }
 
-std::string&& NetworkBuffer::ReadString()
+std::string NetworkBuffer::ReadString()
 {
 	std::string str;
 	size_t size = ReadSize64();
 	str.resize(size);
-	m_buffer->Read(size, &str[0]);
-	return std::move(str);
+	m_view->Read(size, &str[0]);
+	return str;
 }
 
 void NetworkBuffer::WriteString(const std::string& val)
 {
 	WriteSize64(val.size());
-	m_buffer->Write(val.size(), val.data());
+	GetWriteBuffer()->Write(val.size(), val.data());
 }
 
 void NetworkBuffer::WriteString(const char* data)
@@ -381,10 +741,20 @@ void NetworkBuffer::WriteString(const char* data)
 	WriteString(std::string(data));
 }
 
+void NetworkBuffer::ReadArray(size_t count, void* dst, DataType type)
+{
+	ByteUtils::ReadSwapped(m_view, count * ((int)type & 0xFFFF), dst, type);
+}
+
+void NetworkBuffer::WriteArray(size_t count, const void* src, DataType type)
+{
+	ByteUtils::WriteSwapped(GetWriteBuffer(), count * ((int)type & 0xFFFF), src, type);
+}
+
 int64_t NetworkBuffer::ReadLong()
 {
 	int64_t i;
-	m_buffer->Read(i);
+	m_view->Read(i);
 	if (m_transEndian)
 		ByteUtils::ReverseBytes(i);
 	return i;
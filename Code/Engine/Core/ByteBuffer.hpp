@@ -1,6 +1,7 @@
 // ================ BUFFER  UTILITIES SECTION =============== //
 #pragma once
 
+#include <memory>
 #include <vector>
 #include <string>
 
@@ -18,41 +19,21 @@ enum class DataType
 	LONG        = (DATA_TYPE_INTEGER  << 16) | 8,
 };
 
-class ByteBuffer
+// Non-owning, read-only window over bytes someone else keeps alive (a ByteBuffer, a packet, a
+// mapped file). Reads advance m_readIdx up to m_writeIdx, the end of the readable data. Copying a
+// view or slicing one never copies the bytes.
+class ByteBufferView
 {
-private:
-	std::vector<BYTE> m_data;
+protected:
+	const BYTE* m_viewData = nullptr;
 
 public:
 	size_t m_readIdx = 0;
 	size_t m_writeIdx = 0;
 
 public:
-	ByteBuffer(size_t initialCapacity = 0);
-	ByteBuffer(const ByteBuffer& copyFrom, size_t offset = 0, size_t length = -1);
-	virtual ~ByteBuffer();
-	
-	template<typename T>
-	size_t Write(size_t arrLen, const T* arrPtr)
-	{
-		if (!arrLen)
-			return 0;
-
-		size_t appendSize = sizeof(T) * arrLen;
-
-		if (m_data.size() < m_writeIdx + appendSize)
-			m_data.resize(m_writeIdx + appendSize);
-
-		memcpy(&m_data[m_writeIdx], arrPtr, appendSize);
-		m_writeIdx += appendSize;
-		return appendSize;
-	}
-
-	template<typename T>
-	size_t Write(const T& val)
-	{
-		return Write(1, &val);
-	}
+	ByteBufferView() = default;
+	ByteBufferView(const void* data, size_t size);
 
 	template<typename T>
 	size_t Read(size_t arrLen, T* arrPtr)
@@ -65,7 +46,7 @@ public:
 		if (m_readIdx + shrinkSize > m_writeIdx)
 			shrinkSize = m_writeIdx - m_readIdx;
 		
-		memcpy(arrPtr, &m_data[m_readIdx], shrinkSize);
+		memcpy(arrPtr, &m_viewData[m_readIdx], shrinkSize);
 		m_readIdx += shrinkSize;
 		return shrinkSize;
 	}
@@ -76,32 +57,6 @@ public:
 		return Read(1, &val);
 	}
 
-	template<typename T>
-	size_t WriteObject(size_t arrLen, const T* arrPtr)
-	{
-		size_t prevWriteIdx = m_writeIdx;
-		for (size_t i = 0; i < arrLen; i++)
-			WriteObject(arrPtr[i]);
-		return m_writeIdx - prevWriteIdx;
-	}
-
-	template<typename T>
-	size_t WriteObject(size_t arrLen, const T** arrPtr)
-	{
-		size_t prevWriteIdx = m_writeIdx;
-		for (size_t i = 0; i < arrLen; i++)
-			WriteObject(*arrPtr[i]);
-		return m_writeIdx - prevWriteIdx;
-	}
-
-	template<typename T>
-	size_t WriteObject(const T& val)
-	{
-		size_t prevWriteIdx = m_writeIdx;
-		val.WriteBytes(this);
-		return m_writeIdx - prevWriteIdx;
-	}
-
 	template<typename T>
 	size_t ReadObject(size_t arrLen, T* arrPtr)
 	{
@@ -133,24 +88,128 @@ public:
 		return m_readIdx - prevReadIdx;
 	}
 
-	size_t WriteZero(size_t size);
-
 	size_t Skip(size_t size);
 
-	size_t WriteAlignment();
 	size_t ReadAlignment();
 
+	const BYTE* data() const;
+
+	void ResetRead();
+
+	bool IsReadable(size_t size) const;
+
+	size_t GetReadableSize() const;
+
+	// View of the readable bytes from offset on (relative to m_readIdx), clamped to the readable size
+	ByteBufferView Slice(size_t offset = 0, size_t length = -1) const;
+
+	// Slice of the next length bytes, consumed from this view; for sub-parsing a nested block
+	ByteBufferView ReadSlice(size_t length);
+};
+
+// Growable buffer. Capacity doubles and new bytes aren't zeroed. In segmented mode (SetSegmentSize)
+// a full buffer hands its bytes to a segment and carries on in a fresh block instead of reallocating,
+// so huge outputs never get copied; only the bytes of the current block are readable through the view,
+// write the whole thing out with FileWriteFromBuffer (GetSegments).
+class ByteBuffer : public ByteBufferView
+{
+private:
+	struct Segment
+	{
+		std::unique_ptr<BYTE[]> m_data;
+		size_t                  m_begin;
+		size_t                  m_end;
+	};
+
+	std::unique_ptr<BYTE[]> m_data;
+	size_t                  m_capacity = 0;
+	size_t                  m_segmentSize = 0; // 0: a single contiguous block
+	size_t                  m_sealedIdx = 0; // write index where the current block starts
+	std::vector<Segment>    m_segments;
+
+public:
+	ByteBuffer(size_t initialCapacity = 0);
+	ByteBuffer(const ByteBuffer& copyFrom); // the whole buffer like operator=, segments and read index included
+	ByteBuffer(const ByteBuffer& copyFrom, size_t offset, size_t length = -1); // owning copy of a slice of the readable bytes
+	ByteBuffer(ByteBuffer&& moveFrom) noexcept;
+	explicit ByteBuffer(const ByteBufferView& copyFrom); // owning copy of the readable bytes
+	virtual ~ByteBuffer();
+
+	ByteBuffer& operator=(const ByteBuffer& copyFrom);
+	ByteBuffer& operator=(ByteBuffer&& moveFrom) noexcept;
+	
+	template<typename T>
+	size_t Write(size_t arrLen, const T* arrPtr)
+	{
+		if (!arrLen)
+			return 0;
+
+		size_t appendSize = sizeof(T) * arrLen;
+
+		if (m_capacity < m_writeIdx + appendSize)
+			Grow(appendSize);
+
+		memcpy(&m_data[m_writeIdx], arrPtr, appendSize);
+		m_writeIdx += appendSize;
+		return appendSize;
+	}
+
+	template<typename T>
+	size_t Write(const T& val)
+	{
+		return Write(1, &val);
+	}
+
+	template<typename T>
+	size_t WriteObject(size_t arrLen, const T* arrPtr)
+	{
+		size_t prevWriteIdx = m_writeIdx;
+		for (size_t i = 0; i < arrLen; i++)
+			WriteObject(arrPtr[i]);
+		return m_writeIdx - prevWriteIdx;
+	}
+
+	template<typename T>
+	size_t WriteObject(size_t arrLen, const T** arrPtr)
+	{
+		size_t prevWriteIdx = m_writeIdx;
+		for (size_t i = 0; i < arrLen; i++)
+			WriteObject(*arrPtr[i]);
+		return m_writeIdx - prevWriteIdx;
+	}
+
+	template<typename T>
+	size_t WriteObject(const T& val)
+	{
+		size_t prevWriteIdx = m_writeIdx;
+		val.WriteBytes(this);
+		return m_writeIdx - prevWriteIdx;
+	}
+
+	size_t WriteZero(size_t size);
+
+	size_t WriteAlignment();
+
+	using ByteBufferView::data;
 	BYTE* data();
 
 	void Reset();
 
-	void ResetRead();
-
 	void ShrinkBuffer();
 
-	bool IsReadable(size_t size);
-
 	void EnsureWritable(size_t size);
+
+	void Reserve(size_t capacity);
+	size_t GetCapacity() const;
+
+	void SetSegmentSize(size_t segmentSize); // 0 turns segmenting off, existing segments stay
+	size_t GetTotalSize() const; // readable bytes of all segments
+	std::vector<ByteBufferView> GetSegments() const; // in write order, the current block last
+	void ReleaseSegments(); // frees all but the current block, e.g. once they are written out
+
+private:
+	void Grow(size_t appendSize); // room for appendSize more bytes, contiguous
+	void Reallocate(size_t capacity);
 };
 
 class ByteUtils
@@ -170,24 +229,24 @@ public:
 
 	static void ReverseBytes64(BYTE* ptr);
 
-	static void ReadString(ByteBuffer* buffer, std::string& val);
+	static void ReadString(ByteBufferView* buffer, std::string& val);
 
 	static void WriteString(ByteBuffer* buffer, const std::string& val);
 
 	static void WriteString(ByteBuffer* buffer, const char* data);
 
-	static void ReadString_Net(ByteBuffer* buffer, std::string& val);
+	static void ReadString_Net(ByteBufferView* buffer, std::string& val);
 
 	static void WriteString_Net(ByteBuffer* buffer, const std::string& val);
 
 	static void WriteString_Net(ByteBuffer* buffer, const char* data);
 
-	static void ReadVarInt(ByteBuffer* buffer, int& val);
+	static void ReadVarInt(ByteBufferView* buffer, int& val);
 
 	static void WriteVarInt(ByteBuffer* buffer, int val);
 
 	template<typename T>
-	static void ReadArray(ByteBuffer* buffer, std::vector<T>& val)
+	static void ReadArray(ByteBufferView* buffer, std::vector<T>& val)
 	{
 		size_t size;
 		buffer->Read(size);
@@ -203,7 +262,7 @@ public:
 	}
 
 	template<typename T>
-	static void ReadObjects(ByteBuffer* buffer, std::vector<T>& val)
+	static void ReadObjects(ByteBufferView* buffer, std::vector<T>& val)
 	{
 		size_t size;
 		buffer->Read(size);
@@ -221,74 +280,44 @@ public:
 	}
 
 	template<typename T>
-	static void ReadArray_Net(ByteBuffer* buffer, std::vector<T>& val, DataType type)
+	static void ReadArray_Net(ByteBufferView* buffer, std::vector<T>& val, DataType type)
 	{
-		if (IsPlatformBigEndian())
-		{
-			size_t size;
-			buffer->Read(size);
-			val.resize(size);
-			buffer->Read(size, val.data());
-		}
-		else
-		{
-			size_t size;
-			buffer->Read(size);
+		size_t size;
+		buffer->Read(size);
+		if (!IsPlatformBigEndian())
 			ReverseBytes((int64_t&)size);
-			val.resize(size);
-
-			size_t readIdx = buffer->m_readIdx;
-			buffer->Read(size, val.data());
-
-			BYTE* data = (BYTE*)val.data();
-
-			if (((int)type | 0xFFFF) == 2)
-				for (size_t idx = readIdx; idx < buffer->m_readIdx; idx += 2)
-					ByteUtils::ReverseBytes16(&data[idx]);
-			else if (((int)type | 0xFFFF) == 4)
-				for (size_t idx = readIdx; idx < buffer->m_readIdx; idx += 4)
-					ByteUtils::ReverseBytes32(&data[idx]);
-			else if (((int)type | 0xFFFF) == 8)
-				for (size_t idx = readIdx; idx < buffer->m_readIdx; idx += 8)
-					ByteUtils::ReverseBytes64(&data[idx]);
-		}
+		val.resize(size);
+
+		ReadSwapped(buffer, size * sizeof(T), val.data(), type);
 	}
 
 	template<typename T>
 	static void WriteArray_Net(ByteBuffer* buffer, const std::vector<T>& val, DataType type)
 	{
-		if (IsPlatformBigEndian())
-		{
-			buffer->Write(val.size());
-			buffer->Write(val.size(), val.data());
-		}
-		else
-		{
-			size_t size = val.size();
+		size_t size = val.size();
+		if (!IsPlatformBigEndian())
 			ReverseBytes((int64_t&)size);
+		buffer->Write(size);
 
-			buffer->Write(size);
+		WriteSwapped(buffer, val.size() * sizeof(T), val.data(), type);
+	}
 
-			size_t writeIdx = buffer->m_writeIdx;
-			buffer->Write(val.size(), val.data());
+	// Bulk endian flip of count elements of 2, 4 or 8 bytes, SSSE3/AVX2 when the cpu has them.
+	// src and dst may be the same (in place) but must not overlap otherwise.
+	static void ReverseBytesArray(void* data, size_t count, int width);
+	static void CopyReverseBytes(void* dst, const void* src, size_t count, int width);
 
-			if      (((int)type | 0xFFFF) == 2)
-				for (size_t idx = writeIdx; idx < buffer->m_writeIdx; idx += 2)
-					ByteUtils::ReverseBytes16(&buffer->data()[idx]);
-			else if (((int)type | 0xFFFF) == 4)
-				for (size_t idx = writeIdx; idx < buffer->m_writeIdx; idx += 4)
-					ByteUtils::ReverseBytes32(&buffer->data()[idx]);
-			else if (((int)type | 0xFFFF) == 8)
-				for (size_t idx = writeIdx; idx < buffer->m_writeIdx; idx += 8)
-					ByteUtils::ReverseBytes64(&buffer->data()[idx]);
-		}
-	}
+	// Big-endian (network order) bytes to/from native ones while copying, plain copies on big-endian
+	// platforms. size in bytes, a multiple of the type's width.
+	static size_t ReadSwapped(ByteBufferView* buffer, size_t size, void* dst, DataType type);
+	static size_t WriteSwapped(ByteBuffer* buffer, size_t size, const void* src, DataType type);
 };
 
 class NetworkBuffer
 {
 public:
 	NetworkBuffer(ByteBuffer* buffer);
+	NetworkBuffer(ByteBufferView* view); // read only, e.g. over a received packet
 
 	BYTE      ReadByte();
 	int32_t   ReadInt();
@@ -310,12 +339,20 @@ public:
 	void WriteSize32(size_t val);
 	void WriteSize64(size_t val);
 
-	std::string&& ReadString();
+	std::string ReadString();
 	void WriteString(const std::string& val);
 	void WriteString(const char* data);
 
+	// count elements of the type, converted in bulk; far cheaper than a ReadFloat per element
+	void ReadArray(size_t count, void* dst, DataType type);
+	void WriteArray(size_t count, const void* src, DataType type);
+
+private:
+	ByteBuffer* GetWriteBuffer();
+
 private:
-	ByteBuffer* m_buffer;
-	bool        m_transEndian;
+	ByteBufferView* m_view;
+	ByteBuffer*     m_buffer; // null for read only buffers
+	bool            m_transEndian;
 };
 
@@ -0,0 +1,177 @@
+#include "Engine/Core/ByteBufferPool.hpp"
+
+
+// =============================================================================================
+// =============================================================================================
+ByteBufferLease::ByteBufferLease(ByteBufferPool* pool, ByteBuffer* buffer)
+	: m_pool(pool)
+	, m_buffer(buffer)
+{
+}
+
+ByteBufferLease::ByteBufferLease(ByteBufferLease&& moveFrom) noexcept
+	: m_pool(moveFrom.m_pool)
+	, m_buffer(moveFrom.m_buffer)
+{
+	moveFrom.m_pool = nullptr;
+	moveFrom.m_buffer = nullptr;
+}
+
+ByteBufferLease::~ByteBufferLease()
+{
+	Release();
+}
+
+ByteBufferLease& ByteBufferLease::operator=(ByteBufferLease&& moveFrom) noexcept
+{
+	if (this != &moveFrom)
+	{
+		Release();
+		m_pool = moveFrom.m_pool;
+		m_buffer = moveFrom.m_buffer;
+		moveFrom.m_pool = nullptr;
+		moveFrom.m_buffer = nullptr;
+	}
+	return *this;
+}
+
+void ByteBufferLease::Release()
+{
+	if (m_buffer)
+		m_pool->Release(m_buffer);
+	m_pool = nullptr;
+	m_buffer = nullptr;
+}
+
+
+// =============================================================================================
+// =============================================================================================
+ByteBufferPool::ByteBufferPool(int maxBuffersPerClass)
+	: m_maxBuffersPerClass(maxBuffersPerClass)
+{
+	for (SizeClass& sizeClass : m_classes)
+		sizeClass.m_idle.reserve(maxBuffersPerClass);
+}
+
+ByteBufferPool::~ByteBufferPool()
+{
+	Trim();
+}
+
+ByteBufferLease ByteBufferPool::Acquire(size_t capacity)
+{
+	m_numAcquired.fetch_add(1, std::memory_order_relaxed);
+
+	int classIdx = GetAcquireClass(capacity);
+	if (classIdx < 0)
+		return ByteBufferLease(this, new ByteBuffer(capacity)); // too big to pool, freed again on release
+
+	// the request's own class first, then bigger ones: a bigger buffer now beats growing a small one later
+	for (int idx = classIdx; idx < NUM_SIZE_CLASSES; idx++)
+	{
+		SizeClass& sizeClass = m_classes[idx];
+		if (sizeClass.m_numIdle.load(std::memory_order_relaxed) == 0)
+			continue;
+
+		std::lock_guard<std::mutex> guard(sizeClass.m_lock);
+		if (!sizeClass.m_idle.empty())
+		{
+			ByteBuffer* buffer = sizeClass.m_idle.back();
+			sizeClass.m_idle.pop_back();
+			sizeClass.m_numIdle.store((int)sizeClass.m_idle.size(), std::memory_order_relaxed);
+			m_numHits.fetch_add(1, std::memory_order_relaxed);
+			return ByteBufferLease(this, buffer);
+		}
+	}
+
+	// a miss allocates the whole class size, so the buffer comes back to the same class
+	return ByteBufferLease(this, new ByteBuffer(MIN_CLASS_SIZE << classIdx));
+}
+
+void ByteBufferPool::Release(ByteBuffer* buffer)
+{
+	m_numReleased.fetch_add(1, std::memory_order_relaxed);
+
+	buffer->Reset();
+	buffer->SetSegmentSize(0);
+
+	int classIdx = GetReleaseClass(buffer->GetCapacity());
+	if (classIdx >= 0)
+	{
+		SizeClass& sizeClass = m_classes[classIdx];
+		std::lock_guard<std::mutex> guard(sizeClass.m_lock);
+		if ((int)sizeClass.m_idle.size() < m_maxBuffersPerClass)
+		{
+			sizeClass.m_idle.push_back(buffer);
+			sizeClass.m_numIdle.store((int)sizeClass.m_idle.size(), std::memory_order_relaxed);
+			return;
+		}
+	}
+
+	m_numDiscarded.fetch_add(1, std::memory_order_relaxed);
+	delete buffer;
+}
+
+void ByteBufferPool::Trim()
+{
+	for (SizeClass& sizeClass : m_classes)
+	{
+		std::vector<ByteBuffer*> idle;
+		{
+			std::lock_guard<std::mutex> guard(sizeClass.m_lock);
+			idle.swap(sizeClass.m_idle);
+			sizeClass.m_idle.reserve(m_maxBuffersPerClass);
+			sizeClass.m_numIdle.store(0, std::memory_order_relaxed);
+		}
+		for (ByteBuffer* buffer : idle)
+			delete buffer;
+	}
+}
+
+ByteBufferPoolStats ByteBufferPool::GetStats() const
+{
+	ByteBufferPoolStats stats;
+	stats.m_numAcquired = m_numAcquired.load(std::memory_order_relaxed);
+	stats.m_numHits = m_numHits.load(std::memory_order_relaxed);
+	stats.m_numReleased = m_numReleased.load(std::memory_order_relaxed);
+	stats.m_numDiscarded = m_numDiscarded.load(std::memory_order_relaxed);
+	for (const SizeClass& sizeClass : m_classes)
+	{
+		std::lock_guard<std::mutex> guard(sizeClass.m_lock);
+		stats.m_numIdle += sizeClass.m_idle.size();
+		for (const ByteBuffer* buffer : sizeClass.m_idle)
+			stats.m_idleBytes += buffer->GetCapacity();
+	}
+	return stats;
+}
+
+ByteBufferPool& ByteBufferPool::GetShared()
+{
+	// leaked on purpose: static destructors elsewhere may still hand leases back at exit
+	static ByteBufferPool* s_sharedPool = new ByteBufferPool();
+	return *s_sharedPool;
+}
+
+int ByteBufferPool::GetAcquireClass(size_t capacity)
+{
+	int classIdx = 0;
+	while (classIdx < NUM_SIZE_CLASSES && (MIN_CLASS_SIZE << classIdx) < capacity)
+		classIdx++;
+	return classIdx < NUM_SIZE_CLASSES ? classIdx : -1;
+}
+
+int ByteBufferPool::GetReleaseClass(size_t capacity)
+{
+	if (capacity < MIN_CLASS_SIZE)
+		return -1;
+
+	int classIdx = 0;
+	while (classIdx + 1 < NUM_SIZE_CLASSES && (MIN_CLASS_SIZE << (classIdx + 1)) <= capacity)
+		classIdx++;
+
+	// a buffer that grew far past the biggest class would pin all that memory for small requests
+	if (capacity >= MAX_CLASS_SIZE * 2)
+		return -1;
+	return classIdx;
+}
+
@@ -0,0 +1,109 @@
+#pragma once
+
+#include "Engine/Core/ByteBuffer.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+class ByteBufferPool;
+
+
+// =============================================================================================
+// A ByteBuffer on loan from a ByteBufferPool; it goes back (emptied, capacity kept) when the
+// lease is destroyed or released. Move-only, like the buffer it stands for.
+//
+//     ByteBufferLease scratch = ByteBufferPool::GetShared().Acquire(4096);
+//     scratch->Write(...);
+// =============================================================================================
+class ByteBufferLease
+{
+public:
+	ByteBufferLease() = default;
+	ByteBufferLease(ByteBufferPool* pool, ByteBuffer* buffer);
+	ByteBufferLease(ByteBufferLease&& moveFrom) noexcept;
+	ByteBufferLease(const ByteBufferLease& copyFrom) = delete;
+	~ByteBufferLease(); // releases
+
+	ByteBufferLease& operator=(ByteBufferLease&& moveFrom) noexcept;
+	void operator=(const ByteBufferLease& copyFrom) = delete;
+
+	void         Release(); // hands the buffer back early, the lease is empty afterwards
+
+	ByteBuffer*  Get() const                    { return m_buffer; }
+	ByteBuffer*  operator->() const             { return m_buffer; }
+	ByteBuffer&  operator*() const              { return *m_buffer; }
+	explicit operator bool() const              { return m_buffer != nullptr; }
+
+private:
+	ByteBufferPool*  m_pool = nullptr;
+	ByteBuffer*      m_buffer = nullptr;
+};
+
+
+// =============================================================================================
+// =============================================================================================
+struct ByteBufferPoolStats
+{
+	uint64_t m_numAcquired = 0;
+	uint64_t m_numHits = 0; // acquires served by an idle buffer instead of a new one
+	uint64_t m_numReleased = 0;
+	uint64_t m_numDiscarded = 0; // released buffers freed because their class was full or they were too big
+	size_t   m_numIdle = 0; // buffers waiting in the pool right now
+	size_t   m_idleBytes = 0; // and their capacity
+
+	double   GetHitRate() const             { return m_numAcquired ? (double)m_numHits / (double)m_numAcquired : 0.0; }
+};
+
+
+// =============================================================================================
+// Thread-safe pool of ByteBuffers for temporaries on hot paths (packet compression, asset
+// serialization, ...). Idle buffers are kept per size class, doubling from 256 B to 4 MB, and
+// a released buffer is filed under the biggest class its capacity covers, so a buffer that grew
+// while on loan serves bigger requests from then on. Acquire takes from the smallest class that
+// fits and has an idle buffer, so once the pool has warmed up, acquiring and releasing never
+// reaches the heap. Each class has its own lock and keeps at most maxBuffersPerClass idle
+// buffers, the rest are freed.
+// =============================================================================================
+class ByteBufferPool
+{
+public:
+	static constexpr size_t MIN_CLASS_SIZE   = 256;
+	static constexpr int    NUM_SIZE_CLASSES = 15;
+	static constexpr size_t MAX_CLASS_SIZE   = MIN_CLASS_SIZE << (NUM_SIZE_CLASSES - 1); // 4 MB
+
+public:
+	explicit ByteBufferPool(int maxBuffersPerClass = 16);
+	~ByteBufferPool(); // leases must not outlive the pool
+
+	ByteBufferPool(const ByteBufferPool& copyFrom) = delete;
+	void operator=(const ByteBufferPool& copyFrom) = delete;
+
+	ByteBufferLease     Acquire(size_t capacity = 0); // an empty buffer with room for at least capacity bytes
+	void                Release(ByteBuffer* buffer); // leases call this
+	void                Trim(); // frees every idle buffer, e.g. after loading
+	ByteBufferPoolStats GetStats() const;
+
+	static ByteBufferPool& GetShared(); // the engine's pool, never destroyed so leases in statics stay safe
+
+private:
+	struct SizeClass
+	{
+		mutable std::mutex        m_lock;
+		std::vector<ByteBuffer*>  m_idle;
+		std::atomic<int>          m_numIdle = 0; // lets Acquire skip empty classes without locking them
+	};
+
+	static int GetAcquireClass(size_t capacity); // smallest class holding capacity, -1 above MAX_CLASS_SIZE
+	static int GetReleaseClass(size_t capacity); // biggest class capacity covers, -1 below MIN or far above MAX
+
+private:
+	SizeClass              m_classes[NUM_SIZE_CLASSES];
+	int                    m_maxBuffersPerClass = 16;
+	std::atomic<uint64_t>  m_numAcquired = 0;
+	std::atomic<uint64_t>  m_numHits = 0;
+	std::atomic<uint64_t>  m_numReleased = 0;
+	std::atomic<uint64_t>  m_numDiscarded = 0;
+};
+
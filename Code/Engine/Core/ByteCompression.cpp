@@ -0,0 +1,438 @@
+#include "Engine/Core/ByteCompression.hpp"
+
+#include "Engine/Core/ErrorWarningAssert.hpp"
+
+#include <string.h>
+
+
+// =============================================================================================
+// =============================================================================================
+static constexpr int      HASH_LOG = 13; // 8K positions, 16 KB of table; fits L1 with the block
+static constexpr size_t   MIN_MATCH = 4;
+static constexpr size_t   LAST_LITERALS = 5; // the format ends every block with at least 5 literals
+static constexpr size_t   MF_LIMIT = 12; // and no match starts in its last 12 bytes
+static constexpr int      SKIP_TRIGGER = 6; // search step grows every 64 misses, incompressible data goes by fast
+static constexpr uint32_t STORED_RAW = 0x80000000u;
+static constexpr char     STREAM_MAGIC[4] = { 'E', 'C', 'Z', '1' };
+
+static uint32_t Read32(const BYTE* ptr)
+{
+	uint32_t value;
+	memcpy(&value, ptr, sizeof(value));
+	return value;
+}
+
+static uint64_t Read64(const BYTE* ptr)
+{
+	uint64_t value;
+	memcpy(&value, ptr, sizeof(value));
+	return value;
+}
+
+// copies 16 bytes at a time and may run up to 15 bytes past dst + size, callers leave that room
+static void WildCopy16(BYTE* dst, const BYTE* src, size_t size)
+{
+	BYTE* dstEnd = dst + size;
+	do
+	{
+		memcpy(dst, src, 16);
+		dst += 16;
+		src += 16;
+	} while (dst < dstEnd);
+}
+
+static uint32_t ReadLE32(const BYTE* ptr)
+{
+	return (uint32_t)ptr[0] | ((uint32_t)ptr[1] << 8) | ((uint32_t)ptr[2] << 16) | ((uint32_t)ptr[3] << 24);
+}
+
+static void WriteLE32(BYTE* ptr, uint32_t value)
+{
+	ptr[0] = (BYTE)value;
+	ptr[1] = (BYTE)(value >> 8);
+	ptr[2] = (BYTE)(value >> 16);
+	ptr[3] = (BYTE)(value >> 24);
+}
+
+static uint32_t HashSequence(uint32_t sequence)
+{
+	return (sequence * 2654435761u) >> (32 - HASH_LOG);
+}
+
+// the part of a literal or match length that doesn't fit the token's 4 bits
+static BYTE* WriteExtraLength(BYTE* op, size_t length)
+{
+	while (length >= 255)
+	{
+		*op++ = 255;
+		length -= 255;
+	}
+	*op++ = (BYTE)length;
+	return op;
+}
+
+static bool ReadExtraLength(const BYTE*& ip, const BYTE* end, size_t& length)
+{
+	BYTE value;
+	do
+	{
+		if (ip >= end)
+			return false;
+		value = *ip++;
+		length += value;
+	} while (value == 255);
+	return true;
+}
+
+static BYTE* WriteSequence(BYTE* op, const BYTE* literals, size_t literalLength)
+{
+	BYTE* token = op++;
+	*token = (BYTE)((literalLength >= 15 ? 15 : literalLength) << 4);
+	if (literalLength >= 15)
+		op = WriteExtraLength(op, literalLength - 15);
+	memcpy(op, literals, literalLength);
+	return op + literalLength;
+}
+
+
+// =============================================================================================
+// =============================================================================================
+size_t CompressBlockBound(size_t size)
+{
+	return size + size / 255 + 16;
+}
+
+size_t CompressBlock(const BYTE* src, size_t srcSize, BYTE* dst, uint16_t* hashTable)
+{
+	ASSERT_OR_DIE(srcSize <= COMPRESSION_BLOCK_SIZE, "CompressBlock: block bigger than the 64 KB window");
+
+	BYTE* op = dst;
+	const BYTE* anchor = src;
+	const BYTE* end = src + srcSize;
+
+	if (srcSize > MF_LIMIT)
+	{
+		memset(hashTable, 0, sizeof(uint16_t) << HASH_LOG);
+
+		const BYTE* mfLimit = end - MF_LIMIT;
+		const BYTE* matchLimit = end - LAST_LITERALS;
+		const BYTE* ip = src + 1;
+
+		while (ip <= mfLimit)
+		{
+			// greedy: the first position whose 4 bytes hash to an earlier equal sequence
+			const BYTE* match = nullptr;
+			unsigned attempts = 1 << SKIP_TRIGGER;
+			while (ip <= mfLimit)
+			{
+				uint32_t hash = HashSequence(Read32(ip));
+				const BYTE* candidate = src + hashTable[hash];
+				hashTable[hash] = (uint16_t)(ip - src);
+				if (candidate < ip && Read32(candidate) == Read32(ip))
+				{
+					match = candidate;
+					break;
+				}
+				ip += attempts++ >> SKIP_TRIGGER;
+			}
+			if (!match)
+				break;
+
+			while (ip > anchor && match > src && ip[-1] == match[-1])
+			{
+				ip--;
+				match--;
+			}
+
+			const BYTE* matchEnd = ip + MIN_MATCH;
+			const BYTE* ref = match + MIN_MATCH;
+			while (matchEnd + 8 <= matchLimit && Read64(matchEnd) == Read64(ref))
+			{
+				matchEnd += 8;
+				ref += 8;
+			}
+			while (matchEnd < matchLimit && *matchEnd == *ref)
+			{
+				matchEnd++;
+				ref++;
+			}
+
+			BYTE* token = op;
+			op = WriteSequence(op, anchor, ip - anchor);
+
+			size_t offset = ip - match; // under 64 KB, blocks are no bigger
+			*op++ = (BYTE)offset;
+			*op++ = (BYTE)(offset >> 8);
+
+			size_t matchLength = matchEnd - ip - MIN_MATCH;
+			*token |= (BYTE)(matchLength >= 15 ? 15 : matchLength);
+			if (matchLength >= 15)
+				op = WriteExtraLength(op, matchLength - 15);
+
+			ip = anchor = matchEnd;
+			if (ip <= mfLimit)
+				hashTable[HashSequence(Read32(ip - 2))] = (uint16_t)(ip - 2 - src);
+		}
+	}
+
+	op = WriteSequence(op, anchor, end - anchor);
+	return op - dst;
+}
+
+bool DecompressBlock(const BYTE* src, size_t srcSize, BYTE* dst, size_t rawSize)
+{
+	// every length and offset is checked, the bytes may come off the network
+	const BYTE* ip = src;
+	const BYTE* ipEnd = src + srcSize;
+	BYTE* op = dst;
+	BYTE* opEnd = dst + rawSize;
+
+	while (ip < ipEnd)
+	{
+		BYTE token = *ip++;
+
+		size_t literalLength = token >> 4;
+		if (literalLength == 15 && !ReadExtraLength(ip, ipEnd, literalLength))
+			return false;
+		if (literalLength > (size_t)(ipEnd - ip) || literalLength > (size_t)(opEnd - op))
+			return false;
+		if (literalLength + 16 <= (size_t)(ipEnd - ip) && literalLength + 16 <= (size_t)(opEnd - op))
+			WildCopy16(op, ip, literalLength);
+		else
+			memcpy(op, ip, literalLength);
+		ip += literalLength;
+		op += literalLength;
+
+		// the last sequence is literals only
+		if (ip == ipEnd)
+			break;
+
+		if (ipEnd - ip < 2)
+			return false;
+		size_t offset = (size_t)ip[0] | ((size_t)ip[1] << 8);
+		ip += 2;
+		if (offset == 0 || offset > (size_t)(op - dst))
+			return false;
+
+		size_t matchLength = token & 15;
+		if (matchLength == 15 && !ReadExtraLength(ip, ipEnd, matchLength))
+			return false;
+		matchLength += MIN_MATCH;
+		if (matchLength > (size_t)(opEnd - op))
+			return false;
+
+		// overlapping matches repeat the last offset bytes, copy in steps that never read unwritten bytes
+		const BYTE* ref = op - offset;
+		if (offset >= 16 && matchLength + 16 <= (size_t)(opEnd - op))
+		{
+			WildCopy16(op, ref, matchLength);
+			op += matchLength;
+			continue;
+		}
+		while (matchLength)
+		{
+			size_t step = matchLength < offset ? matchLength : offset;
+			memcpy(op, ref, step);
+			op += step;
+			ref += step;
+			matchLength -= step;
+		}
+	}
+
+	return op == opEnd;
+}
+
+bool CompressBuffer(const ByteBufferView& input, ByteBuffer& output)
+{
+	ByteCompressor compressor(&output);
+	compressor.Write(input);
+	compressor.Finish();
+	return true;
+}
+
+bool DecompressBuffer(const ByteBufferView& input, ByteBuffer& output)
+{
+	ByteDecompressor decompressor(&output);
+	return decompressor.Feed(input) && decompressor.IsFinished();
+}
+
+
+// =============================================================================================
+// =============================================================================================
+ByteCompressor::ByteCompressor(ByteBuffer* output)
+	: m_output(output)
+	, m_block(ByteBufferPool::GetShared().Acquire(COMPRESSION_BLOCK_SIZE))
+	, m_hashTable(ByteBufferPool::GetShared().Acquire(sizeof(uint16_t) << HASH_LOG))
+{
+	m_output->Write(sizeof(STREAM_MAGIC), STREAM_MAGIC);
+	m_numBytesOut += sizeof(STREAM_MAGIC);
+}
+
+ByteCompressor::~ByteCompressor()
+{
+	Finish();
+}
+
+void ByteCompressor::Write(size_t size, const void* data)
+{
+	GUARANTEE_OR_DIE(!m_finished, "ByteCompressor: writing after Finish");
+
+	const BYTE* bytes = (const BYTE*)data;
+	m_numBytesIn += size;
+	while (size)
+	{
+		// whole blocks compress straight from the caller's bytes
+		if (m_blockFill == 0 && size >= COMPRESSION_BLOCK_SIZE)
+		{
+			FlushBlock(bytes, COMPRESSION_BLOCK_SIZE);
+			bytes += COMPRESSION_BLOCK_SIZE;
+			size -= COMPRESSION_BLOCK_SIZE;
+			continue;
+		}
+
+		size_t copySize = COMPRESSION_BLOCK_SIZE - m_blockFill;
+		if (copySize > size)
+			copySize = size;
+		memcpy(&m_block->data()[m_blockFill], bytes, copySize);
+		m_blockFill += copySize;
+		bytes += copySize;
+		size -= copySize;
+
+		if (m_blockFill == COMPRESSION_BLOCK_SIZE)
+		{
+			FlushBlock(m_block->data(), m_blockFill);
+			m_blockFill = 0;
+		}
+	}
+}
+
+void ByteCompressor::Write(const ByteBufferView& view)
+{
+	Write(view.GetReadableSize(), &view.data()[view.m_readIdx]);
+}
+
+void ByteCompressor::Finish()
+{
+	if (m_finished)
+		return;
+
+	if (m_blockFill)
+	{
+		FlushBlock(m_block->data(), m_blockFill);
+		m_blockFill = 0;
+	}
+
+	BYTE endMarker[8] = {};
+	m_output->Write(sizeof(endMarker), endMarker);
+	m_numBytesOut += sizeof(endMarker);
+	m_finished = true;
+}
+
+void ByteCompressor::FlushBlock(const BYTE* data, size_t size)
+{
+	m_output->EnsureWritable(8 + CompressBlockBound(size));
+	BYTE* header = &m_output->data()[m_output->m_writeIdx];
+
+	size_t storedSize = CompressBlock(data, size, header + 8, (uint16_t*)m_hashTable->data());
+	uint32_t storedField = (uint32_t)storedSize;
+	if (storedSize >= size)
+	{
+		memcpy(header + 8, data, size);
+		storedSize = size;
+		storedField = (uint32_t)size | STORED_RAW;
+	}
+	WriteLE32(header, (uint32_t)size);
+	WriteLE32(header + 4, storedField);
+
+	m_output->m_writeIdx += 8 + storedSize;
+	m_numBytesOut += 8 + storedSize;
+}
+
+
+// =============================================================================================
+// =============================================================================================
+ByteDecompressor::ByteDecompressor(ByteBuffer* output)
+	: m_output(output)
+{
+}
+
+bool ByteDecompressor::Feed(const ByteBufferView& input)
+{
+	if (m_corrupt || m_finished)
+		return !m_corrupt;
+
+	const BYTE* data = &input.data()[input.m_readIdx];
+	size_t size = input.GetReadableSize();
+
+	if (m_pending.GetReadableSize() == 0)
+	{
+		// the usual case: decode in place, copy only the tail of a split block
+		m_pending.Reset();
+		size_t consumed = DecodeBlocks(data, size);
+		if (!m_corrupt && !m_finished)
+			m_pending.Write(size - consumed, data + consumed);
+	}
+	else
+	{
+		m_pending.Write(size, data);
+		m_pending.m_readIdx += DecodeBlocks(&m_pending.data()[m_pending.m_readIdx], m_pending.GetReadableSize());
+		m_pending.ShrinkBuffer();
+	}
+	return !m_corrupt;
+}
+
+size_t ByteDecompressor::DecodeBlocks(const BYTE* data, size_t size)
+{
+	size_t pos = 0;
+	if (!m_headerRead)
+	{
+		if (size < sizeof(STREAM_MAGIC))
+			return 0;
+		if (memcmp(data, STREAM_MAGIC, sizeof(STREAM_MAGIC)) != 0)
+		{
+			m_corrupt = true;
+			return 0;
+		}
+		m_headerRead = true;
+		pos = sizeof(STREAM_MAGIC);
+	}
+
+	while (!m_finished && size - pos >= 8)
+	{
+		uint32_t rawSize = ReadLE32(&data[pos]);
+		uint32_t storedField = ReadLE32(&data[pos + 4]);
+		size_t storedSize = storedField & ~STORED_RAW;
+		bool isRaw = (storedField & STORED_RAW) != 0;
+
+		if (rawSize == 0)
+		{
+			m_corrupt = storedField != 0;
+			m_finished = !m_corrupt;
+			pos += 8;
+			break;
+		}
+		if (rawSize > COMPRESSION_BLOCK_SIZE || storedSize > CompressBlockBound(COMPRESSION_BLOCK_SIZE) || (isRaw && storedSize != rawSize))
+		{
+			m_corrupt = true;
+			break;
+		}
+		if (size - pos - 8 < storedSize)
+			break; // rest of the block comes with the next Feed
+
+		m_output->EnsureWritable(rawSize);
+		BYTE* dst = &m_output->data()[m_output->m_writeIdx];
+		if (isRaw)
+		{
+			memcpy(dst, &data[pos + 8], rawSize);
+		}
+		else if (!DecompressBlock(&data[pos + 8], storedSize, dst, rawSize))
+		{
+			m_corrupt = true;
+			break;
+		}
+		m_output->m_writeIdx += rawSize;
+		pos += 8 + storedSize;
+	}
+	return pos;
+}
+
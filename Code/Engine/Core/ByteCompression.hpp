@@ -0,0 +1,82 @@
+#pragma once
+
+#include "Engine/Core/ByteBuffer.hpp"
+#include "Engine/Core/ByteBufferPool.hpp"
+
+#include <cstdint>
+
+
+// =============================================================================================
+// LZ4-style compression for cooked assets and large packets; fast over small. Blocks use the LZ4
+// block format (greedy matching, 64 KB window), streams wrap them as:
+//
+//     "ECZ1"  then per block  uint32 rawSize, uint32 storedSize (top bit: stored uncompressed), bytes
+//             and a block with rawSize 0 to end the stream
+//
+// all little-endian. Blocks that don't shrink are stored as they are, so nothing ever grows by more
+// than the 8 bytes of a block header per 64 KB.
+// =============================================================================================
+constexpr size_t COMPRESSION_BLOCK_SIZE = 64 * 1024;
+
+size_t CompressBlockBound(size_t size); // worst case output of CompressBlock
+size_t CompressBlock(const BYTE* src, size_t srcSize, BYTE* dst, uint16_t* hashTable); // dst holds CompressBlockBound(srcSize), returns the size written
+bool   DecompressBlock(const BYTE* src, size_t srcSize, BYTE* dst, size_t rawSize); // false on corrupt data
+
+bool   CompressBuffer(const ByteBufferView& input, ByteBuffer& output); // the readable bytes of input, appended to output as a stream
+bool   DecompressBuffer(const ByteBufferView& input, ByteBuffer& output); // one whole stream
+
+
+// =============================================================================================
+// Streaming stage: bytes written in go out compressed, one block at a time
+// =============================================================================================
+class ByteCompressor
+{
+public:
+	explicit ByteCompressor(ByteBuffer* output);
+	~ByteCompressor(); // finishes
+
+	void   Write(size_t size, const void* data);
+	void   Write(const ByteBufferView& view); // the readable bytes
+	void   Finish(); // flushes the last block and ends the stream
+
+	size_t GetNumBytesIn() const           { return m_numBytesIn; }
+	size_t GetNumBytesOut() const          { return m_numBytesOut; }
+
+private:
+	void   FlushBlock(const BYTE* data, size_t size);
+
+private:
+	ByteBuffer*                  m_output = nullptr;
+	ByteBufferLease              m_block; // both from the shared pool, a compressor per packet costs no allocation
+	size_t                       m_blockFill = 0;
+	ByteBufferLease              m_hashTable;
+	size_t                       m_numBytesIn = 0;
+	size_t                       m_numBytesOut = 0;
+	bool                         m_finished = false;
+};
+
+
+// =============================================================================================
+// Streaming stage the other way. Feed takes input in pieces of any size (e.g. as it comes off a
+// socket or a file), decodes every complete block and keeps the rest for the next call.
+// =============================================================================================
+class ByteDecompressor
+{
+public:
+	explicit ByteDecompressor(ByteBuffer* output);
+
+	bool   Feed(const ByteBufferView& input); // false once the stream is corrupt
+	bool   IsFinished() const              { return m_finished; }
+	bool   IsCorrupt() const               { return m_corrupt; }
+
+private:
+	size_t DecodeBlocks(const BYTE* data, size_t size); // returns the bytes consumed
+
+private:
+	ByteBuffer*  m_output = nullptr;
+	ByteBuffer   m_pending; // start of a block that isn't complete yet
+	bool         m_headerRead = false;
+	bool         m_finished = false;
+	bool         m_corrupt = false;
+};
+
@@ -0,0 +1,396 @@
+#pragma once
+
+#include "Engine/Core/ByteBuffer.hpp"
+
+#include <cstdint>
+#include <array>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+
+// =============================================================================================
+// Field lists for ByteBuffer serialization. A type describes its layout once:
+//
+//     template<> struct ByteSchema<Bone>
+//     {
+//         static constexpr auto Fields()
+//         {
+//             return std::make_tuple(
+//                 SchemaTag("BONE"), SchemaTag("DATA"),
+//                 SchemaMember("name", &Bone::m_name),
+//                 SchemaMember("id", &Bone::m_id), ...);
+//         }
+//     };
+//
+// and its ReadBytes/WriteBytes call SchemaRead/SchemaWrite. The reads and writes are generated at
+// compile time from the list: adjacent plain members become one memcpy, adjacent tags one write.
+// Strings, vectors and types with ReadBytes/WriteBytes go through ByteUtils as before, so the bytes
+// match hand-written code field for field. GetSchemaHash<T>() is a compile-time FNV-1a of the list,
+// down through vector elements and nested schemas, for version checks.
+// =============================================================================================
+template<typename T>
+struct ByteSchema;
+
+template<typename Class, typename T>
+struct ByteSchemaMember
+{
+	const char*      m_name;
+	T Class::*       m_member;
+	int              m_swapType; // DataType to swap to network order, 0 for native bytes
+};
+
+struct ByteSchemaTag
+{
+	const char*      m_tag; // 4 characters, skipped when reading
+};
+
+struct ByteSchemaAlign
+{
+};
+
+template<typename Class, typename T>
+constexpr ByteSchemaMember<Class, T> SchemaMember(const char* name, T Class::* member)
+{
+	return { name, member, 0 };
+}
+
+// elements converted to big endian on the wire, e.g. SchemaMemberNet("ticks", &Animation::m_ticks, DataType::FLOAT)
+template<typename Class, typename T>
+constexpr ByteSchemaMember<Class, T> SchemaMemberNet(const char* name, T Class::* member, DataType type)
+{
+	return { name, member, (int)type };
+}
+
+constexpr ByteSchemaTag SchemaTag(const char* tag)
+{
+	return { tag };
+}
+
+constexpr ByteSchemaAlign SchemaAlign()
+{
+	return {};
+}
+
+
+// =============================================================================================
+// =================================   INLINE FUNCTIONS   ======================================
+// =============================================================================================
+constexpr uint32_t HashSchemaBytes(uint32_t hash, const char* str)
+{
+	while (*str)
+	{
+		hash ^= (BYTE)*str++;
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+constexpr uint32_t HashSchemaBytes(uint32_t hash, uint32_t value)
+{
+	for (int i = 0; i < 4; i++)
+	{
+		hash ^= (value >> (i * 8)) & 0xFF;
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+template<typename T>
+constexpr uint32_t GetSchemaHash();
+
+template<typename T, typename = void>
+struct HasByteSerialization : std::false_type {};
+
+template<typename T>
+struct HasByteSerialization<T, std::void_t<decltype(std::declval<T&>().ReadBytes((ByteBufferView*)nullptr))>> : std::true_type {};
+
+// only sees a ByteSchema specialization declared before the hash is taken
+template<typename T, typename = void>
+struct HasByteSchema : std::false_type {};
+
+template<typename T>
+struct HasByteSchema<T, std::void_t<decltype(ByteSchema<T>::Fields())>> : std::true_type {};
+
+// members that aren't copied as plain bytes; HashType folds what the bytes depend on into a schema hash
+template<typename T>
+struct ByteSchemaCodec
+{
+	static constexpr bool IS_PLAIN = !HasByteSerialization<T>::value;
+	static_assert(!IS_PLAIN || std::is_trivially_copyable_v<T>, "plain schema members are copied with memcpy, give the type ReadBytes/WriteBytes or a ByteSchemaCodec");
+
+	static void Write(const T& field, ByteBuffer* buffer)    { field.WriteBytes(buffer); }
+	static void Read(T& field, ByteBufferView* buffer)       { field.ReadBytes(buffer); }
+
+	static constexpr uint32_t HashType(uint32_t hash)
+	{
+		if constexpr (IS_PLAIN)
+			return HashSchemaBytes(hash, (uint32_t)sizeof(T));
+		else if constexpr (HasByteSchema<T>::value)
+			return HashSchemaBytes(hash, GetSchemaHash<T>());
+		else
+			return HashSchemaBytes(hash, "OBJECT"); // hand-written ReadBytes/WriteBytes, nothing to look into
+	}
+};
+
+template<>
+struct ByteSchemaCodec<std::string>
+{
+	static constexpr bool IS_PLAIN = false;
+
+	static void Write(const std::string& field, ByteBuffer* buffer)    { ByteUtils::WriteString(buffer, field); }
+	static void Read(std::string& field, ByteBufferView* buffer)       { ByteUtils::ReadString(buffer, field); }
+
+	static constexpr uint32_t HashType(uint32_t hash)                  { return HashSchemaBytes(hash, "STRING"); }
+};
+
+template<typename E>
+struct ByteSchemaCodec<std::vector<E>>
+{
+	static constexpr bool IS_PLAIN = false;
+
+	static void Write(const std::vector<E>& field, ByteBuffer* buffer)
+	{
+		if constexpr (HasByteSerialization<E>::value)
+			ByteUtils::WriteObjects(buffer, field);
+		else
+			ByteUtils::WriteArray(buffer, field);
+	}
+
+	static void Read(std::vector<E>& field, ByteBufferView* buffer)
+	{
+		if constexpr (HasByteSerialization<E>::value)
+			ByteUtils::ReadObjects(buffer, field);
+		else
+			ByteUtils::ReadArray(buffer, field);
+	}
+
+	static constexpr uint32_t HashType(uint32_t hash)
+	{
+		return ByteSchemaCodec<E>::HashType(HashSchemaBytes(hash, "VECTOR"));
+	}
+};
+
+
+// =============================================================================================
+// The entry list walked at compile time. A run is a stretch of entries that goes out in one call:
+// plain members swapped the same way, or tags. Everything else is a run of one.
+// =============================================================================================
+template<typename T>
+inline constexpr auto SCHEMA_FIELDS = ByteSchema<T>::Fields();
+
+template<typename T>
+inline constexpr size_t SCHEMA_NUM_FIELDS = std::tuple_size_v<std::remove_const_t<decltype(SCHEMA_FIELDS<T>)>>;
+
+template<typename Entry>
+struct ByteSchemaEntryTraits
+{
+	static constexpr bool IS_PLAIN = false;
+	static constexpr bool IS_TAG = std::is_same_v<Entry, ByteSchemaTag>;
+};
+
+template<typename Class, typename T>
+struct ByteSchemaEntryTraits<ByteSchemaMember<Class, T>>
+{
+	static constexpr bool IS_PLAIN = ByteSchemaCodec<T>::IS_PLAIN;
+	static constexpr bool IS_TAG = false;
+};
+
+template<typename T, size_t I>
+using SchemaEntryTraits = ByteSchemaEntryTraits<std::remove_cvref_t<decltype(std::get<I>(SCHEMA_FIELDS<T>))>>;
+
+template<typename T, size_t I>
+constexpr bool SchemaEntriesMerge()
+{
+	if constexpr (I + 1 >= SCHEMA_NUM_FIELDS<T>)
+		return false;
+	else if constexpr (SchemaEntryTraits<T, I>::IS_TAG)
+		return SchemaEntryTraits<T, I + 1>::IS_TAG;
+	else if constexpr (SchemaEntryTraits<T, I>::IS_PLAIN && SchemaEntryTraits<T, I + 1>::IS_PLAIN)
+		return std::get<I>(SCHEMA_FIELDS<T>).m_swapType == std::get<I + 1>(SCHEMA_FIELDS<T>).m_swapType;
+	else
+		return false;
+}
+
+// one past the last entry of the run starting at FIRST
+template<typename T, size_t FIRST>
+constexpr size_t GetSchemaRunEnd()
+{
+	if constexpr (SchemaEntriesMerge<T, FIRST>())
+		return GetSchemaRunEnd<T, FIRST + 1>();
+	else
+		return FIRST + 1;
+}
+
+template<typename T, size_t FIRST, size_t... IDX>
+constexpr auto MakeSchemaTags(std::index_sequence<IDX...>)
+{
+	std::array<char, sizeof...(IDX) * 4> tags = {};
+	auto addTag = [&tags](size_t idx, const char* tag)
+		{
+			for (size_t c = 0; c < 4; c++)
+				tags[idx * 4 + c] = tag[c];
+		};
+	(addTag(IDX, std::get<FIRST + IDX>(SCHEMA_FIELDS<T>).m_tag), ...);
+	return tags;
+}
+
+// the tags of a run back to back
+template<typename T, size_t FIRST, size_t COUNT>
+inline constexpr auto SCHEMA_TAGS = MakeSchemaTags<T, FIRST>(std::make_index_sequence<COUNT>());
+
+template<typename T, size_t FIRST, size_t... IDX>
+constexpr size_t GetSchemaRunSize(std::index_sequence<IDX...>)
+{
+	return (sizeof(std::declval<const T&>().*std::get<FIRST + IDX>(SCHEMA_FIELDS<T>).m_member) + ... + 0);
+}
+
+// the run's members follow each other in the object, in list order and without padding; folds to a constant
+template<typename T, size_t FIRST, size_t... IDX>
+bool IsSchemaRunContiguous(const T& object, std::index_sequence<IDX...>)
+{
+	const BYTE* next = (const BYTE*)&(object.*std::get<FIRST>(SCHEMA_FIELDS<T>).m_member);
+	auto follows = [&next](const auto& field)
+		{
+			bool isNext = (const BYTE*)&field == next;
+			next += sizeof(field);
+			return isNext;
+		};
+	return (follows(object.*std::get<FIRST + IDX>(SCHEMA_FIELDS<T>).m_member) && ...);
+}
+
+template<int SWAP_TYPE>
+void WriteSchemaBytes(ByteBuffer* buffer, size_t size, const void* src)
+{
+	if constexpr (SWAP_TYPE == 0)
+		buffer->Write(size, (const BYTE*)src);
+	else
+		ByteUtils::WriteSwapped(buffer, size, src, (DataType)SWAP_TYPE);
+}
+
+template<int SWAP_TYPE>
+void ReadSchemaBytes(ByteBufferView* buffer, size_t size, void* dst)
+{
+	if constexpr (SWAP_TYPE == 0)
+		buffer->Read(size, (BYTE*)dst);
+	else
+		ByteUtils::ReadSwapped(buffer, size, dst, (DataType)SWAP_TYPE);
+}
+
+template<typename T, size_t FIRST, size_t... IDX>
+void WriteSchemaRun(const T& object, ByteBuffer* buffer, std::index_sequence<IDX...> run)
+{
+	constexpr const auto& first = std::get<FIRST>(SCHEMA_FIELDS<T>);
+	if constexpr (SchemaEntryTraits<T, FIRST>::IS_TAG)
+	{
+		constexpr const auto& tags = SCHEMA_TAGS<T, FIRST, sizeof...(IDX)>;
+		buffer->Write(tags.size(), tags.data());
+	}
+	else if constexpr (SchemaEntryTraits<T, FIRST>::IS_PLAIN)
+	{
+		constexpr int SWAP_TYPE = first.m_swapType;
+		if (IsSchemaRunContiguous<T, FIRST>(object, run))
+			WriteSchemaBytes<SWAP_TYPE>(buffer, GetSchemaRunSize<T, FIRST>(run), &(object.*first.m_member));
+		else
+			(WriteSchemaBytes<SWAP_TYPE>(buffer, sizeof(object.*std::get<FIRST + IDX>(SCHEMA_FIELDS<T>).m_member), &(object.*std::get<FIRST + IDX>(SCHEMA_FIELDS<T>).m_member)), ...);
+	}
+	else if constexpr (std::is_same_v<std::remove_cvref_t<decltype(first)>, ByteSchemaAlign>)
+	{
+		buffer->WriteAlignment();
+	}
+	else
+	{
+		ByteSchemaCodec<std::remove_cvref_t<decltype(object.*first.m_member)>>::Write(object.*first.m_member, buffer);
+	}
+}
+
+template<typename T, size_t FIRST, size_t... IDX>
+void ReadSchemaRun(T& object, ByteBufferView* buffer, std::index_sequence<IDX...> run)
+{
+	constexpr const auto& first = std::get<FIRST>(SCHEMA_FIELDS<T>);
+	if constexpr (SchemaEntryTraits<T, FIRST>::IS_TAG)
+	{
+		buffer->Skip(sizeof...(IDX) * 4);
+	}
+	else if constexpr (SchemaEntryTraits<T, FIRST>::IS_PLAIN)
+	{
+		constexpr int SWAP_TYPE = first.m_swapType;
+		if (IsSchemaRunContiguous<T, FIRST>(object, run))
+			ReadSchemaBytes<SWAP_TYPE>(buffer, GetSchemaRunSize<T, FIRST>(run), &(object.*first.m_member));
+		else
+			(ReadSchemaBytes<SWAP_TYPE>(buffer, sizeof(object.*std::get<FIRST + IDX>(SCHEMA_FIELDS<T>).m_member), &(object.*std::get<FIRST + IDX>(SCHEMA_FIELDS<T>).m_member)), ...);
+	}
+	else if constexpr (std::is_same_v<std::remove_cvref_t<decltype(first)>, ByteSchemaAlign>)
+	{
+		buffer->ReadAlignment();
+	}
+	else
+	{
+		ByteSchemaCodec<std::remove_cvref_t<decltype(object.*first.m_member)>>::Read(object.*first.m_member, buffer);
+	}
+}
+
+template<typename T, size_t FIRST>
+void WriteSchemaFrom(const T& object, ByteBuffer* buffer)
+{
+	if constexpr (FIRST < SCHEMA_NUM_FIELDS<T>)
+	{
+		constexpr size_t END = GetSchemaRunEnd<T, FIRST>();
+		WriteSchemaRun<T, FIRST>(object, buffer, std::make_index_sequence<END - FIRST>());
+		WriteSchemaFrom<T, END>(object, buffer);
+	}
+}
+
+template<typename T, size_t FIRST>
+void ReadSchemaFrom(T& object, ByteBufferView* buffer)
+{
+	if constexpr (FIRST < SCHEMA_NUM_FIELDS<T>)
+	{
+		constexpr size_t END = GetSchemaRunEnd<T, FIRST>();
+		ReadSchemaRun<T, FIRST>(object, buffer, std::make_index_sequence<END - FIRST>());
+		ReadSchemaFrom<T, END>(object, buffer);
+	}
+}
+
+template<typename T>
+void SchemaWrite(const T& object, ByteBuffer* buffer)
+{
+	WriteSchemaFrom<T, 0>(object, buffer);
+}
+
+template<typename T>
+void SchemaRead(T& object, ByteBufferView* buffer)
+{
+	ReadSchemaFrom<T, 0>(object, buffer);
+}
+
+template<typename Class, typename T>
+constexpr uint32_t HashSchemaEntry(uint32_t hash, const ByteSchemaMember<Class, T>& member)
+{
+	hash = HashSchemaBytes(hash, member.m_name);
+	hash = ByteSchemaCodec<T>::HashType(hash);
+	return HashSchemaBytes(hash, (uint32_t)member.m_swapType);
+}
+
+constexpr uint32_t HashSchemaEntry(uint32_t hash, const ByteSchemaTag& tag)
+{
+	return HashSchemaBytes(hash, tag.m_tag);
+}
+
+constexpr uint32_t HashSchemaEntry(uint32_t hash, const ByteSchemaAlign&)
+{
+	return HashSchemaBytes(hash, "ALIGN");
+}
+
+// names, sizes and order of the fields, and of the element and nested types behind them; changes whenever the layout on disk does
+template<typename T>
+constexpr uint32_t GetSchemaHash()
+{
+	return std::apply([](const auto&... entries)
+		{
+			uint32_t hash = 2166136261u;
+			((hash = HashSchemaEntry(hash, entries)), ...);
+			return hash;
+		}, ByteSchema<T>::Fields());
+}
@@ -0,0 +1,285 @@
+#include "Engine/Core/Checksum.hpp"
+
+#include <immintrin.h>
+#include <string.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define CHECKSUM_TARGET(isa)
+#else
+#define CHECKSUM_TARGET(isa) __attribute__((target(isa)))
+#endif
+
+
+// =============================================================================================
+// =============================================================================================
+static constexpr uint32_t CRC32C_POLY = 0x82F63B78u; // reflected Castagnoli polynomial
+static constexpr char     FOOTER_MAGIC[4] = { 'E', 'C', 'R', 'C' };
+
+static constexpr uint64_t PRIME64_1 = 0x9E3779B185EBCA87ull;
+static constexpr uint64_t PRIME64_2 = 0xC2B2AE3D27D4EB4Full;
+static constexpr uint64_t PRIME64_3 = 0x165667B19E3779F9ull;
+static constexpr uint64_t PRIME64_4 = 0x85EBCA77C2B2AE63ull;
+static constexpr uint64_t PRIME64_5 = 0x27D4EB2F165667C5ull;
+
+static bool DetectSSE42()
+{
+#if defined(_MSC_VER)
+	int info[4];
+	__cpuid(info, 1);
+	return (info[2] & (1 << 20)) != 0;
+#else
+	__builtin_cpu_init();
+	return __builtin_cpu_supports("sse4.2");
+#endif
+}
+
+static const bool s_hasSSE42 = DetectSSE42();
+
+static uint32_t Read32(const BYTE* ptr)
+{
+	uint32_t value;
+	memcpy(&value, ptr, sizeof(value));
+	return value;
+}
+
+static uint64_t Read64(const BYTE* ptr)
+{
+	uint64_t value;
+	memcpy(&value, ptr, sizeof(value));
+	return value;
+}
+
+static uint32_t ReadLE32(const BYTE* ptr)
+{
+	return (uint32_t)ptr[0] | ((uint32_t)ptr[1] << 8) | ((uint32_t)ptr[2] << 16) | ((uint32_t)ptr[3] << 24);
+}
+
+static uint64_t ReadLE64(const BYTE* ptr)
+{
+	return (uint64_t)ReadLE32(ptr) | ((uint64_t)ReadLE32(ptr + 4) << 32);
+}
+
+static void WriteLE32(BYTE* ptr, uint32_t value)
+{
+	ptr[0] = (BYTE)value;
+	ptr[1] = (BYTE)(value >> 8);
+	ptr[2] = (BYTE)(value >> 16);
+	ptr[3] = (BYTE)(value >> 24);
+}
+
+static void WriteLE64(BYTE* ptr, uint64_t value)
+{
+	WriteLE32(ptr, (uint32_t)value);
+	WriteLE32(ptr + 4, (uint32_t)(value >> 32));
+}
+
+static uint64_t RotateLeft64(uint64_t value, int bits)
+{
+	return (value << bits) | (value >> (64 - bits));
+}
+
+
+// =============================================================================================
+// CRC32C kernels, both take and return the crc without the final inversion
+// =============================================================================================
+CHECKSUM_TARGET("sse4.2")
+static uint32_t Crc32c_SSE42(const BYTE* data, size_t size, uint32_t crc)
+{
+#if defined(_M_X64) || defined(__x86_64__)
+	uint64_t crc64 = crc;
+	for (; size >= 8; size -= 8, data += 8)
+		crc64 = _mm_crc32_u64(crc64, Read64(data));
+	crc = (uint32_t)crc64;
+#endif
+	for (; size >= 4; size -= 4, data += 4)
+		crc = _mm_crc32_u32(crc, Read32(data));
+	for (; size; size--, data++)
+		crc = _mm_crc32_u8(crc, *data);
+	return crc;
+}
+
+// slicing by 8: eight bytes per step through eight 1 KB tables
+struct Crc32cTables
+{
+	uint32_t m_table[8][256];
+
+	Crc32cTables()
+	{
+		for (uint32_t i = 0; i < 256; i++)
+		{
+			uint32_t crc = i;
+			for (int bit = 0; bit < 8; bit++)
+				crc = (crc >> 1) ^ (CRC32C_POLY & (0u - (crc & 1)));
+			m_table[0][i] = crc;
+		}
+		for (int slice = 1; slice < 8; slice++)
+		{
+			for (uint32_t i = 0; i < 256; i++)
+				m_table[slice][i] = (m_table[slice - 1][i] >> 8) ^ m_table[0][m_table[slice - 1][i] & 0xFF];
+		}
+	}
+};
+
+static uint32_t Crc32c_Table(const BYTE* data, size_t size, uint32_t crc)
+{
+	static const Crc32cTables s_tables;
+	const uint32_t (*table)[256] = s_tables.m_table;
+
+	for (; size >= 8; size -= 8, data += 8)
+	{
+		uint32_t low = crc ^ ReadLE32(data);
+		uint32_t high = ReadLE32(data + 4);
+		crc = table[7][low & 0xFF] ^ table[6][(low >> 8) & 0xFF] ^ table[5][(low >> 16) & 0xFF] ^ table[4][low >> 24]
+			^ table[3][high & 0xFF] ^ table[2][(high >> 8) & 0xFF] ^ table[1][(high >> 16) & 0xFF] ^ table[0][high >> 24];
+	}
+	for (; size; size--, data++)
+		crc = (crc >> 8) ^ table[0][(crc ^ *data) & 0xFF];
+	return crc;
+}
+
+
+// =============================================================================================
+// =============================================================================================
+uint32_t Crc32c(const void* data, size_t size, uint32_t crc)
+{
+	crc = ~crc;
+	if (s_hasSSE42)
+		crc = Crc32c_SSE42((const BYTE*)data, size, crc);
+	else
+		crc = Crc32c_Table((const BYTE*)data, size, crc);
+	return ~crc;
+}
+
+uint32_t Crc32c(const ByteBufferView& view, uint32_t crc)
+{
+	return Crc32c(&view.data()[view.m_readIdx], view.GetReadableSize(), crc);
+}
+
+uint32_t Crc32c(const ByteBuffer& buffer, uint32_t crc)
+{
+	for (const ByteBufferView& segment : buffer.GetSegments())
+		crc = Crc32c(segment, crc);
+	return crc;
+}
+
+static uint64_t Hash64Round(uint64_t acc, uint64_t input)
+{
+	acc += input * PRIME64_2;
+	acc = RotateLeft64(acc, 31);
+	return acc * PRIME64_1;
+}
+
+static uint64_t Hash64MergeRound(uint64_t acc, uint64_t value)
+{
+	acc ^= Hash64Round(0, value);
+	return acc * PRIME64_1 + PRIME64_4;
+}
+
+uint64_t Hash64(const void* data, size_t size, uint64_t seed)
+{
+	const BYTE* ptr = (const BYTE*)data;
+	const BYTE* end = ptr + size;
+	uint64_t hash;
+
+	if (size >= 32)
+	{
+		// four independent lanes over 32 byte stripes
+		uint64_t v1 = seed + PRIME64_1 + PRIME64_2;
+		uint64_t v2 = seed + PRIME64_2;
+		uint64_t v3 = seed;
+		uint64_t v4 = seed - PRIME64_1;
+		for (; ptr + 32 <= end; ptr += 32)
+		{
+			v1 = Hash64Round(v1, Read64(ptr));
+			v2 = Hash64Round(v2, Read64(ptr + 8));
+			v3 = Hash64Round(v3, Read64(ptr + 16));
+			v4 = Hash64Round(v4, Read64(ptr + 24));
+		}
+
+		hash = RotateLeft64(v1, 1) + RotateLeft64(v2, 7) + RotateLeft64(v3, 12) + RotateLeft64(v4, 18);
+		hash = Hash64MergeRound(hash, v1);
+		hash = Hash64MergeRound(hash, v2);
+		hash = Hash64MergeRound(hash, v3);
+		hash = Hash64MergeRound(hash, v4);
+	}
+	else
+	{
+		hash = seed + PRIME64_5;
+	}
+
+	hash += (uint64_t)size;
+	for (; ptr + 8 <= end; ptr += 8)
+	{
+		hash ^= Hash64Round(0, Read64(ptr));
+		hash = RotateLeft64(hash, 27) * PRIME64_1 + PRIME64_4;
+	}
+	if (ptr + 4 <= end)
+	{
+		hash ^= (uint64_t)Read32(ptr) * PRIME64_1;
+		hash = RotateLeft64(hash, 23) * PRIME64_2 + PRIME64_3;
+		ptr += 4;
+	}
+	for (; ptr < end; ptr++)
+	{
+		hash ^= (uint64_t)*ptr * PRIME64_5;
+		hash = RotateLeft64(hash, 11) * PRIME64_1;
+	}
+
+	// final avalanche
+	hash ^= hash >> 33;
+	hash *= PRIME64_2;
+	hash ^= hash >> 29;
+	hash *= PRIME64_3;
+	hash ^= hash >> 32;
+	return hash;
+}
+
+uint64_t Hash64(const ByteBufferView& view, uint64_t seed)
+{
+	return Hash64(&view.data()[view.m_readIdx], view.GetReadableSize(), seed);
+}
+
+
+// =============================================================================================
+// =============================================================================================
+void AppendChecksumFooter(ByteBuffer& buffer)
+{
+	uint64_t payloadSize = 0;
+	uint32_t crc = 0;
+	for (const ByteBufferView& segment : buffer.GetSegments())
+	{
+		crc = Crc32c(segment, crc);
+		payloadSize += segment.GetReadableSize();
+	}
+
+	WriteChecksumFooter(buffer, payloadSize, crc);
+}
+
+void WriteChecksumFooter(ByteBuffer& output, uint64_t payloadSize, uint32_t crc)
+{
+	BYTE footer[CHECKSUM_FOOTER_SIZE];
+	WriteLE64(footer, payloadSize);
+	WriteLE32(footer + 8, crc);
+	memcpy(footer + 12, FOOTER_MAGIC, sizeof(FOOTER_MAGIC));
+	output.Write(CHECKSUM_FOOTER_SIZE, footer);
+}
+
+ChecksumFooter StripChecksumFooter(ByteBufferView& view)
+{
+	size_t readableSize = view.GetReadableSize();
+	if (readableSize < CHECKSUM_FOOTER_SIZE)
+		return ChecksumFooter::NONE;
+
+	size_t payloadSize = readableSize - CHECKSUM_FOOTER_SIZE;
+	const BYTE* payload = &view.data()[view.m_readIdx];
+	const BYTE* footer = payload + payloadSize;
+	if (memcmp(footer + 12, FOOTER_MAGIC, sizeof(FOOTER_MAGIC)) != 0 || ReadLE64(footer) != (uint64_t)payloadSize)
+		return ChecksumFooter::NONE;
+
+	if (Crc32c(payload, payloadSize) != ReadLE32(footer + 8))
+		return ChecksumFooter::CORRUPT;
+
+	view.m_writeIdx -= CHECKSUM_FOOTER_SIZE;
+	return ChecksumFooter::VALID;
+}
+
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "Engine/Core/ByteBuffer.hpp"
+
+#include <cstdint>
+
+
+// =============================================================================================
+// Integrity checks for cooked assets and packets. Both run at several GB/s:
+//
+//     Crc32c  CRC-32C (Castagnoli), the SSE4.2 crc32 instruction when the cpu has it, a sliced
+//             table otherwise. Same values as iSCSI/ext4/etc, and it can be continued piece by piece.
+//     Hash64  64-bit non-crypto hash, the xxHash64 algorithm (same values on little-endian
+//             platforms). For hash tables and content ids, not for anything an attacker controls.
+// =============================================================================================
+uint32_t Crc32c(const void* data, size_t size, uint32_t crc = 0); // pass the previous result to continue
+uint32_t Crc32c(const ByteBufferView& view, uint32_t crc = 0); // the readable bytes
+uint32_t Crc32c(const ByteBuffer& buffer, uint32_t crc = 0); // the readable bytes of every segment
+
+uint64_t Hash64(const void* data, size_t size, uint64_t seed = 0);
+uint64_t Hash64(const ByteBufferView& view, uint64_t seed = 0); // the readable bytes of one contiguous view
+
+
+// =============================================================================================
+// Optional footer after a cooked file's bytes (or any other blob):
+//
+//     uint64 payloadSize, uint32 crc32c of the payload, "ECRC"          all little-endian
+//
+// Readers that know about it check and strip it; the payload size has to match too, so a file
+// that just happens to end in "ECRC" isn't taken for one with a footer.
+// =============================================================================================
+constexpr size_t CHECKSUM_FOOTER_SIZE = 16;
+
+enum class ChecksumFooter
+{
+	NONE,
+	VALID,
+	CORRUPT,
+};
+
+void           AppendChecksumFooter(ByteBuffer& buffer); // over the readable bytes of every segment
+void           WriteChecksumFooter(ByteBuffer& output, uint64_t payloadSize, uint32_t crc); // for payloads that went out piece by piece
+ChecksumFooter StripChecksumFooter(ByteBufferView& view); // a valid footer comes off the readable bytes, anything else leaves them as they are
+
@@ -0,0 +1,132 @@
+#include "Engine/Core/CompressionBenchmark.hpp"
+
+#include "Engine/Animation/Animation.hpp"
+#include "Engine/Core/ByteBuffer.hpp"
+#include "Engine/Core/ByteCompression.hpp"
+#include "Engine/Core/Checksum.hpp"
+#include "Engine/Core/DevConsole.hpp"
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Core/Time.hpp"
+#include "Engine/Core/VertexUtils.hpp"
+#include "Engine/Core/Vertex_PCU.hpp"
+#include "Engine/Math/MathUtils.hpp"
+
+#include <math.h>
+#include <string.h>
+
+
+// =================================================================================
+// =================================================================================
+static void BenchmarkPrint(const std::string& text)
+{
+	DebuggerPrintf("[CompressionBenchmark] %s\n", text.c_str());
+	if (g_theConsole)
+		g_theConsole->AddLine(DevConsole::LOG_INFO, text);
+}
+
+static void RunCompressionPasses(const char* name, const ByteBuffer& raw)
+{
+	constexpr int NUM_PASSES = 8;
+
+	ByteBuffer compressed;
+	double startTime = GetCurrentTimeSeconds();
+	for (int pass = 0; pass < NUM_PASSES; pass++)
+	{
+		compressed.Reset();
+		CompressBuffer(raw, compressed);
+	}
+	double compressTime = (GetCurrentTimeSeconds() - startTime) / NUM_PASSES;
+
+	ByteBuffer decompressed(raw.m_writeIdx);
+	bool intact = true;
+	startTime = GetCurrentTimeSeconds();
+	for (int pass = 0; pass < NUM_PASSES; pass++)
+	{
+		decompressed.Reset();
+		intact = DecompressBuffer(compressed, decompressed) && intact;
+	}
+	double decompressTime = (GetCurrentTimeSeconds() - startTime) / NUM_PASSES;
+
+	intact = intact && decompressed.m_writeIdx == raw.m_writeIdx && memcmp(decompressed.data(), raw.data(), raw.m_writeIdx) == 0;
+
+	double megabytes = (double)raw.m_writeIdx / (1024.0 * 1024.0);
+	BenchmarkPrint(Stringf("  %-10s %8.2f MB -> %8.2f MB (%5.1f%%)  compress %8.1f MB/s  decompress %8.1f MB/s%s", name,
+		megabytes, (double)compressed.m_writeIdx / (1024.0 * 1024.0), 100.0 * (double)compressed.m_writeIdx / (double)raw.m_writeIdx,
+		compressTime > 0.0 ? megabytes / compressTime : 0.0, decompressTime > 0.0 ? megabytes / decompressTime : 0.0, intact ? "" : " MISMATCH"));
+	// what verifying the same bytes costs
+	uint32_t crc = 0;
+	startTime = GetCurrentTimeSeconds();
+	for (int pass = 0; pass < NUM_PASSES; pass++)
+		crc ^= Crc32c(raw);
+	double crcTime = (GetCurrentTimeSeconds() - startTime) / NUM_PASSES;
+
+	uint64_t hash = 0;
+	startTime = GetCurrentTimeSeconds();
+	for (int pass = 0; pass < NUM_PASSES; pass++)
+		hash ^= Hash64(raw, (uint64_t)pass);
+	double hashTime = (GetCurrentTimeSeconds() - startTime) / NUM_PASSES;
+
+	BenchmarkPrint(Stringf("  %-10s crc32c %8.1f MB/s  hash64 %8.1f MB/s  (%08x %016llx)", "",
+		crcTime > 0.0 ? megabytes / crcTime : 0.0, hashTime > 0.0 ? megabytes / hashTime : 0.0, crc, (unsigned long long)hash));
+}
+
+
+// =================================================================================
+// =================================================================================
+void CompressionBenchmark_Mesh(int numVerts)
+{
+	BenchmarkPrint(Stringf("Mesh: %d Vertex_PCU", numVerts));
+
+	// spheres of varying size and tint, the usual mix of repeated colors and uvs with noisy positions
+	VertexList verts;
+	verts.reserve(numVerts);
+	for (int sphere = 0; (int)verts.size() < numVerts; sphere++)
+	{
+		Vec3 center((float)(sphere % 17) * 3.0f, (float)(sphere % 5) * 2.0f, (float)sphere * 0.25f);
+		Rgba8 color((unsigned char)(sphere * 37), (unsigned char)(sphere * 91), 255, 255);
+		AddVertsForSphere(verts, center, 0.5f + (float)(sphere % 7) * 0.25f, color);
+	}
+	verts.resize(numVerts);
+
+	ByteBuffer raw;
+	raw.Write(verts.size(), verts.data());
+	RunCompressionPasses("vertices", raw);
+}
+
+void CompressionBenchmark_Animation(int numBones, int numKeys)
+{
+	BenchmarkPrint(Stringf("Animation: %d bone curves, %d keys each", numBones, numKeys));
+
+	// sampled at 30 fps like the importer bakes them: smooth positions, rotations, constant scale
+	ByteBuffer raw;
+	for (int bone = 0; bone < numBones; bone++)
+	{
+		AnimationCurve curve(numKeys, numKeys, numKeys);
+		for (int key = 0; key < numKeys; key++)
+		{
+			float time = (float)key / 30.0f;
+			curve.m_posTimes[key] = curve.m_rotTimes[key] = curve.m_scalingTimes[key] = time;
+			curve.m_positions[key] = Vec3(sinf(time + (float)bone), cosf(time * 0.5f), (float)bone * 0.1f);
+			curve.m_rotations[key] = Quaternion::FromAxisAndAngle(Vec3(0.0f, 0.0f, 1.0f), time * 0.3f + (float)bone);
+			curve.m_scalings[key] = Vec3(1.0f, 1.0f, 1.0f);
+		}
+		curve.WriteBytes(&raw);
+	}
+	RunCompressionPasses("curves", raw);
+}
+
+bool Command_CompressionBenchmark(EventArgs& args)
+{
+	std::string test = args.GetValue("test", "all");
+	int verts = atoi(args.GetValue("verts", "200000").c_str());
+	int bones = atoi(args.GetValue("bones", "64").c_str());
+	int keys = atoi(args.GetValue("keys", "600").c_str());
+
+	if (test == "all" || test == "mesh")
+		CompressionBenchmark_Mesh(verts > 0 ? verts : 1);
+	if (test == "all" || test == "animation")
+		CompressionBenchmark_Animation(bones > 0 ? bones : 1, keys > 0 ? keys : 1);
+	return true;
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include "Engine/Core/EventSystem.hpp"
+
+
+// =================================================================================
+// Throughput and ratio of ByteCompression on the kind of data we cook: vertex
+// arrays and animation curves, and what checksumming them costs. Results go to
+// the DevConsole (if any) and the debugger output.
+//
+// Console: CompressionBenchmark test=all verts=200000 bones=64 keys=600
+// =================================================================================
+void CompressionBenchmark_Mesh(int numVerts);
+void CompressionBenchmark_Animation(int numBones, int numKeys);
+
+bool Command_CompressionBenchmark(EventArgs& args);
@@ -0,0 +1,134 @@
+#include "Engine/Core/CpuTopology.hpp"
+
+#include "Engine/Core/StringUtils.hpp"
+
+#include <algorithm>
+#include <thread>
+
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+
+
+// =============================================================================================
+// =============================================================================================
+static int CountBits(uint64_t mask)
+{
+	int count = 0;
+	for (; mask; mask &= mask - 1)
+		count++;
+	return count;
+}
+
+
+// =============================================================================================
+// =============================================================================================
+const CpuTopology& CpuTopology::Get()
+{
+	static CpuTopology s_topology;
+	return s_topology;
+}
+
+CpuTopology::CpuTopology()
+{
+	Detect();
+}
+
+void CpuTopology::Detect()
+{
+	DWORD length = 0;
+	GetLogicalProcessorInformationEx(RelationAll, nullptr, &length);
+
+	std::vector<uint8_t> buffer(length);
+	auto* info = (SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX*)buffer.data();
+	if (length == 0 || !GetLogicalProcessorInformationEx(RelationAll, info, &length))
+	{
+		// no topology, treat every logical processor as a core of a single node
+		int numLogical = (int)std::thread::hardware_concurrency();
+		m_numLogicalProcessors = numLogical > 0 ? numLogical : 1;
+		m_cores.assign(m_numLogicalProcessors, CpuCore());
+		for (int i = 0; i < m_numLogicalProcessors && i < 64; i++)
+			m_cores[i].m_logicalMask = 1ull << i;
+		return;
+	}
+
+	struct NumaNode
+	{
+		int          m_number;
+		uint16_t     m_group;
+		uint64_t     m_mask;
+	};
+	std::vector<NumaNode> nodes;
+
+	m_cores.clear();
+	for (DWORD offset = 0; offset < length; )
+	{
+		auto* entry = (SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX*)(buffer.data() + offset);
+		if (entry->Relationship == RelationProcessorCore)
+		{
+			CpuCore core;
+			core.m_group = entry->Processor.GroupMask[0].Group;
+			core.m_logicalMask = (uint64_t)entry->Processor.GroupMask[0].Mask;
+			core.m_numLogical = CountBits(core.m_logicalMask);
+			m_cores.push_back(core);
+		}
+		else if (entry->Relationship == RelationNumaNode)
+		{
+			nodes.push_back({ (int)entry->NumaNode.NodeNumber, entry->NumaNode.GroupMask.Group, (uint64_t)entry->NumaNode.GroupMask.Mask });
+		}
+		offset += entry->Size;
+	}
+
+	// node numbers can be sparse, map them to 0..n-1
+	std::sort(nodes.begin(), nodes.end(), [](const NumaNode& a, const NumaNode& b) { return a.m_number < b.m_number; });
+	m_numNumaNodes = 0;
+	int lastNumber = -1;
+	for (NumaNode& node : nodes)
+	{
+		if (node.m_number != lastNumber)
+		{
+			lastNumber = node.m_number;
+			m_numNumaNodes++;
+		}
+		node.m_number = m_numNumaNodes - 1;
+	}
+	if (m_numNumaNodes == 0)
+		m_numNumaNodes = 1;
+
+	m_numLogicalProcessors = 0;
+	for (CpuCore& core : m_cores)
+	{
+		m_numLogicalProcessors += core.m_numLogical;
+		for (const NumaNode& node : nodes)
+		{
+			if (node.m_group == core.m_group && (node.m_mask & core.m_logicalMask))
+			{
+				core.m_numaNode = node.m_number;
+				break;
+			}
+		}
+	}
+
+	std::stable_sort(m_cores.begin(), m_cores.end(), [](const CpuCore& a, const CpuCore& b) { return a.m_numaNode < b.m_numaNode; });
+}
+
+std::string CpuTopology::GetDescription() const
+{
+	std::string description = Stringf("%d physical cores, %d logical processors, %d NUMA node(s)",
+		GetNumPhysicalCores(), m_numLogicalProcessors, m_numNumaNodes);
+
+	for (int node = 0; node < m_numNumaNodes && m_numNumaNodes > 1; node++)
+	{
+		int numCores = (int)std::count_if(m_cores.begin(), m_cores.end(), [node](const CpuCore& core) { return core.m_numaNode == node; });
+		description += Stringf("; node %d: %d cores", node, numCores);
+	}
+	return description;
+}
+
+bool CpuTopology::PinCurrentThread(const CpuCore& core)
+{
+	GROUP_AFFINITY affinity = {};
+	affinity.Group = core.m_group;
+	affinity.Mask = (KAFFINITY)core.m_logicalMask;
+	return SetThreadGroupAffinity(GetCurrentThread(), &affinity, nullptr) != 0;
+}
+
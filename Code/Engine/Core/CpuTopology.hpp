@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+
+// =============================================================================================
+// One physical core and the logical processors (hyper-threads) on it
+// =============================================================================================
+struct CpuCore
+{
+	int          m_numaNode = 0;
+	uint16_t     m_group = 0;        // processor group, machines with more than 64 logical processors have several
+	uint64_t     m_logicalMask = 0;  // logical processors of the core within its group
+	int          m_numLogical = 1;
+};
+
+
+// =============================================================================================
+// Cores and NUMA nodes of the machine, detected once
+// =============================================================================================
+class CpuTopology
+{
+public:
+	static const CpuTopology& Get();
+
+	int          GetNumPhysicalCores() const     { return (int)m_cores.size(); }
+	int          GetNumLogicalProcessors() const { return m_numLogicalProcessors; }
+	int          GetNumNumaNodes() const         { return m_numNumaNodes; }
+	std::string  GetDescription() const;
+
+	static bool  PinCurrentThread(const CpuCore& core); // to the logical processors of the core
+
+public:
+	std::vector<CpuCore>     m_cores; // sorted by NUMA node
+	int                      m_numLogicalProcessors = 1;
+	int                      m_numNumaNodes = 1;
+
+private:
+	CpuTopology();
+	void Detect();
+};
+
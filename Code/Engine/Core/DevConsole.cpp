@@ -1,8 +1,11 @@
 #include "Engine/Core/DevConsole.hpp"
 
+#include "Engine/Core/ByteBufferPool.hpp"
+#include "Engine/Core/CompressionBenchmark.hpp"
 #include "Engine/Core/EngineCommon.hpp"
 #include "Engine/Core/ErrorWarningAssert.hpp"
 #include "Engine/Core/EventSystem.hpp"
+#include "Engine/Core/EventSystemBenchmark.hpp"
 #include "Engine/Core/Time.hpp"
 #include "Engine/Core/StringUtils.hpp"
 #include "Engine/Core/VertexUtils.hpp"
@@ -89,6 +92,17 @@ bool Command_DebugRendererToggle(EventArgs& args)
 	return true;
 }
 
+bool Command_ByteBufferPoolStats(EventArgs& args)
+{
+	UNUSED(args);
+
+	ByteBufferPoolStats stats = ByteBufferPool::GetShared().GetStats();
+	g_theConsole->AddLine(DevConsole::LOG_INFO, Stringf("ByteBufferPool: %llu acquired, %.1f%% hits, %llu discarded, %zu idle (%.2f MB)",
+		(unsigned long long)stats.m_numAcquired, stats.GetHitRate() * 100.0, (unsigned long long)stats.m_numDiscarded,
+		stats.m_numIdle, (double)stats.m_idleBytes / (1024.0 * 1024.0)));
+	return true;
+}
+
 void DevConsole::Startup()
 {
 	m_mainThreadId = std::this_thread::get_id();
@@ -100,6 +114,9 @@ void DevConsole::Startup()
 	g_theEventSystem->SubscribeEventCallbackFunction("Input:KeyPressed", Event_KeyPressed);
 	g_theEventSystem->SubscribeEventCallbackFunction("DebugRendererClear", Command_DebugRendererClear);
 	g_theEventSystem->SubscribeEventCallbackFunction("DebugRendererToggle", Command_DebugRendererToggle);
+	g_theEventSystem->SubscribeEventCallbackFunction("CompressionBenchmark", Command_CompressionBenchmark);
+	g_theEventSystem->SubscribeEventCallbackFunction("ByteBufferPoolStats", Command_ByteBufferPoolStats);
+	g_theEventSystem->SubscribeEventCallbackFunction("EventSystemBenchmark", Command_EventSystemBenchmark);
 
     g_theEventSystem->Subscribe("ExecuteCommand", [this](auto args)
         {
@@ -1,7 +1,78 @@
 #include "EventSystem.hpp"
 
+#include <string_view>
+
 EventSystem* g_theEventSystem = nullptr;
 
+// the snapshot this thread last fired through; see EventSystem::m_subscriptions
+struct FireSnapshotCache
+{
+	const EventSystem*                           m_owner = nullptr;
+	uint64_t                                     m_version = 0;
+	std::shared_ptr<const EventSubscriptionMap>  m_subscriptions;
+	int                                          m_numFiring = 0; // FireEvents in progress on this thread
+	std::vector<std::shared_ptr<const EventSubscriptionMap>> m_retired; // snapshots replaced while a FireEvent was still walking them, dropped when m_numFiring gets back to 0
+
+	void Drop()
+	{
+		if (m_numFiring > 0 && m_subscriptions)
+			m_retired.push_back(std::move(m_subscriptions));
+		m_subscriptions.reset();
+		m_owner = nullptr;
+		m_version = 0;
+	}
+};
+
+// counts a dispatch in progress on this thread, also when a callback throws
+struct FiringScope
+{
+	FiringScope(FireSnapshotCache& cache, const std::atomic<uint64_t>& snapshotVersion)
+		: m_cache(cache)
+		, m_snapshotVersion(snapshotVersion)
+	{
+		m_cache.m_numFiring++;
+	}
+
+	~FiringScope()
+	{
+		if (--m_cache.m_numFiring > 0)
+			return;
+
+		m_cache.m_retired.clear();
+		// the subscriptions changed while firing (a callback unsubscribed, say): let go of the old ones
+		// now, this thread may not fire again for a long time
+		if (m_cache.m_version != m_snapshotVersion.load(std::memory_order_acquire))
+			m_cache.Drop();
+	}
+
+	FiringScope(const FiringScope&) = delete;
+	FiringScope& operator=(const FiringScope&) = delete;
+
+	FireSnapshotCache&              m_cache;
+	const std::atomic<uint64_t>&    m_snapshotVersion;
+};
+
+static thread_local FireSnapshotCache s_fireCache;
+static std::atomic<uint64_t> s_nextSnapshotVersion = 1;
+
+// lowercases into buffer when the name fits, so a fire doesn't allocate for the lookup
+static std::string_view GetLookupName(const std::string& eventName, char* buffer, size_t bufferSize, std::string& longName)
+{
+	if (eventName.size() > bufferSize)
+	{
+		longName = tolower(eventName);
+		return longName;
+	}
+
+	// same folding as tolower(char), kept inline here since it runs on every fire
+	for (size_t idx = 0; idx < eventName.size(); idx++)
+	{
+		char c = eventName[idx];
+		buffer[idx] = (c >= 'A' && c <= 'Z') ? (char)(c - 'A' + 'a') : c;
+	}
+	return std::string_view(buffer, eventName.size());
+}
+
 
 EventSubscription::EventSubscription(EventHandler handler, Subscriber subscriber, EventCallbackFP functionPtr)
     : m_handler(handler)
@@ -24,6 +95,16 @@ EventSubscription::EventSubscription(EventHandler handler, Subscriber subscriber
 EventSystem::EventSystem(const EventSystemConfig& theConfig)
     : m_theConfig(theConfig)
 {
+	PublishSnapshot(std::make_shared<const EventSubscriptionMap>());
+}
+
+EventSystem::~EventSystem()
+{
+	// the calling thread's cached snapshot would keep every callback alive until it fires again,
+	// other threads drop theirs when they next fire
+	FireSnapshotCache& cache = s_fireCache;
+	if (cache.m_owner == this)
+		cache.Drop();
 }
 
 void EventSystem::Startup()
@@ -50,82 +131,96 @@ EventHandler EventSystem::SubscribeEventCallbackFunction(const std::string& even
 {
 	std::lock_guard<std::mutex> guard(m_subscriptionMutex);
 
-    return m_subscriptionListMap[tolower(eventName)].Subscribe(functionPtr, subscriber);
+	std::shared_ptr<SubscriptionList> list = CopyList(*m_subscriptions.load(), eventName);
+	EventHandler handle = list->Subscribe(functionPtr, subscriber);
+	PublishList(eventName, std::move(list));
+	return handle;
 }
 
 void EventSystem::UnsubscribeEventCallbackFunction(const std::string& eventName, EventCallbackFP functionPtr)
 {
 	std::lock_guard<std::mutex> guard(m_subscriptionMutex);
 
-	auto ite = m_subscriptionListMap.find(tolower(eventName));
-	if (ite != m_subscriptionListMap.end())
-		ite->second.Unsubscribe(functionPtr);
+	std::shared_ptr<SubscriptionList> list = CopyList(*m_subscriptions.load(), eventName);
+	if (list->Unsubscribe(functionPtr))
+		PublishList(eventName, std::move(list));
 }
 
 EventHandler EventSystem::Subscribe(const std::string& eventName, const EventCallback& callback, Subscriber subscriber)
 {
 	std::lock_guard<std::mutex> guard(m_subscriptionMutex);
 
-	return m_subscriptionListMap[tolower(eventName)].Subscribe(callback, subscriber);
+	std::shared_ptr<SubscriptionList> list = CopyList(*m_subscriptions.load(), eventName);
+	EventHandler handle = list->Subscribe(callback, subscriber);
+	PublishList(eventName, std::move(list));
+	return handle;
 }
 
 void EventSystem::Unsubscribe(const std::string& eventName, EventHandler handle)
 {
 	std::lock_guard<std::mutex> guard(m_subscriptionMutex);
 
-	auto ite = m_subscriptionListMap.find(tolower(eventName));
-	if (ite != m_subscriptionListMap.end())
-		ite->second.Unsubscribe(handle);
+	std::shared_ptr<SubscriptionList> list = CopyList(*m_subscriptions.load(), eventName);
+	if (list->Unsubscribe(handle))
+		PublishList(eventName, std::move(list));
 }
 
 void EventSystem::Unsubscribe(const std::string& eventName, Subscriber subscriber)
 {
 	std::lock_guard<std::mutex> guard(m_subscriptionMutex);
 
-	auto ite = m_subscriptionListMap.find(tolower(eventName));
-	if (ite != m_subscriptionListMap.end())
-		ite->second.Unsubscribe(subscriber);
+	std::shared_ptr<SubscriptionList> list = CopyList(*m_subscriptions.load(), eventName);
+	if (list->Unsubscribe(subscriber))
+		PublishList(eventName, std::move(list));
 }
 
 void EventSystem::Unsubscribe(Subscriber subscriber)
 {
 	std::lock_guard<std::mutex> guard(m_subscriptionMutex);
 
-	for (auto& pair : m_subscriptionListMap)
+	// one new snapshot for all events, and none if the subscriber had nothing left (EventRecipient calls this on destruction)
+	std::shared_ptr<const EventSubscriptionMap> current = m_subscriptions.load();
+	std::shared_ptr<EventSubscriptionMap> next;
+	for (const auto& pair : *current)
 	{
-		pair.second.Unsubscribe(subscriber);
+		if (!pair.second->HasSubscriber(subscriber))
+			continue;
+
+		if (!next)
+			next = std::make_shared<EventSubscriptionMap>(*current);
+		std::shared_ptr<SubscriptionList> list = std::make_shared<SubscriptionList>(*pair.second);
+		list->Unsubscribe(subscriber);
+		next->at(pair.first) = std::move(list);
 	}
+
+	if (next)
+		PublishSnapshot(std::move(next));
 }
 
 bool EventSystem::FireEvent(const std::string& eventName, EventArgs& args) const
 {
-	std::vector<EventSubscription> list;
+	FireSnapshotCache& cache = s_fireCache;
 
+	// loaded after the version, the snapshot is at least that new: PublishSnapshot stores it first
+	uint64_t version = m_snapshotVersion.load(std::memory_order_acquire);
+	if (cache.m_version != version)
 	{
-		std::lock_guard<std::mutex> guard(m_subscriptionMutex);
-
-		auto ite = m_subscriptionListMap.find(tolower(eventName));
-		if (ite != m_subscriptionListMap.end())
-		{
-			list = ite->second.m_list;
-		}
+		// when fired from inside a callback the outer FireEvent is still walking the cached snapshot, Drop keeps it alive until it is done
+		cache.Drop();
+		cache.m_subscriptions = m_subscriptions.load(std::memory_order_acquire);
+		cache.m_owner = this;
+		cache.m_version = version;
 	}
+	const EventSubscriptionMap* subscriptions = cache.m_subscriptions.get();
 
-	for (const auto& subscription : list)
-	{
-		bool consumed;
-		if (!subscription.m_functionPtr)
-		{
-			consumed = subscription.m_callback(args);
-		}
-		else
-		{
-			consumed = subscription.m_functionPtr(args);
-		}
-		if (consumed)
-			return true;
-	}
-	return false;
+	char nameBuffer[128];
+	std::string longName;
+	auto ite = subscriptions->find(GetLookupName(eventName, nameBuffer, sizeof(nameBuffer), longName));
+	if (ite == subscriptions->end())
+		return false;
+
+	FiringScope firing(cache, m_snapshotVersion);
+	return ite->second->Dispatch(args);
 }
 
 bool EventSystem::FireEvent(const std::string& eventName) const
@@ -136,17 +231,39 @@ bool EventSystem::FireEvent(const std::string& eventName) const
 
 void EventSystem::GetRegisteredEventNames(std::vector<std::string>& outNames) const
 {
-	std::lock_guard<std::mutex> guard(m_subscriptionMutex);
+	std::shared_ptr<const EventSubscriptionMap> subscriptions = m_subscriptions.load(std::memory_order_acquire);
 
-    for (const auto& mapEntry : m_subscriptionListMap)
+    for (const auto& mapEntry : *subscriptions)
     {
-        if (!mapEntry.second.m_list.empty())
+        if (!mapEntry.second->m_list.empty())
         {
             outNames.push_back(mapEntry.first);
         }
     }
 }
 
+std::shared_ptr<SubscriptionList> EventSystem::CopyList(const EventSubscriptionMap& subscriptions, const std::string& eventName) const
+{
+	auto ite = subscriptions.find(tolower(eventName));
+	if (ite == subscriptions.end())
+		return std::make_shared<SubscriptionList>();
+	return std::make_shared<SubscriptionList>(*ite->second);
+}
+
+void EventSystem::PublishList(const std::string& eventName, std::shared_ptr<const SubscriptionList> list)
+{
+	// only called with m_subscriptionMutex held, so nobody swaps the snapshot between our load and store
+	std::shared_ptr<EventSubscriptionMap> next = std::make_shared<EventSubscriptionMap>(*m_subscriptions.load());
+	(*next)[tolower(eventName)] = std::move(list);
+	PublishSnapshot(std::move(next));
+}
+
+void EventSystem::PublishSnapshot(std::shared_ptr<const EventSubscriptionMap> subscriptions)
+{
+	m_subscriptions.store(std::move(subscriptions), std::memory_order_release);
+	m_snapshotVersion.store(s_nextSnapshotVersion.fetch_add(1, std::memory_order_relaxed), std::memory_order_release);
+}
+
 EventRecipient::EventRecipient(EventSystem& eventSystem)
     : m_eventSystem(eventSystem)
 {
@@ -171,43 +288,58 @@ EventHandler SubscriptionList::Subscribe(const EventCallback& callback, Subscrib
 	return handle;
 }
 
-void SubscriptionList::Unsubscribe(EventCallbackFP fp)
+bool SubscriptionList::Unsubscribe(EventCallbackFP fp)
 {
 	for (auto ite = m_list.begin(); ite != m_list.end(); ++ite)
 	{
 		if (ite->m_functionPtr == fp)
 		{
 			m_list.erase(ite);
-			return;
+			return true;
 		}
 	}
+	return false;
 }
 
-void SubscriptionList::Unsubscribe(EventHandler handle)
+bool SubscriptionList::Unsubscribe(EventHandler handle)
 {
 	for (auto ite = m_list.begin(); ite != m_list.end(); ++ite)
 	{
 		if (ite->m_handler == handle)
 		{
 			m_list.erase(ite);
-			return;
+			return true;
 		}
 	}
+	return false;
 }
 
-void SubscriptionList::Unsubscribe(Subscriber subscriber)
+bool SubscriptionList::Unsubscribe(Subscriber subscriber)
 {
+	bool removed = false;
 	for (auto ite = m_list.begin(); ite != m_list.end(); )
 	{
 		if (ite->m_subscriber == subscriber)
 		{
 			ite = m_list.erase(ite);
+			removed = true;
 		}
 		else
 		{
 			++ite;
 		}
 	}
+	return removed;
+}
+
+bool SubscriptionList::HasSubscriber(Subscriber subscriber) const
+{
+	for (const auto& subscription : m_list)
+	{
+		if (subscription.m_subscriber == subscriber)
+			return true;
+	}
+	return false;
 }
 
 bool SubscriptionList::Dispatch(EventArgs& args) const
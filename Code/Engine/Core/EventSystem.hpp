@@ -1,8 +1,11 @@
 #pragma once
 
 #include "Engine/Core/NamedStrings.hpp"
+#include <atomic>
 #include <map>
+#include <memory>
 #include <mutex>
+#include <vector>
 
 #include <functional>
 
@@ -41,6 +44,8 @@ private:
     EventCallback   m_callback;
 };
 
+// The subscribers of one event. Once published by the EventSystem a list is never modified again:
+// writers edit a copy and publish that, so a dispatch can run over a list without holding any lock.
 class SubscriptionList
 {
 	friend class EventSystem;
@@ -48,9 +53,10 @@ class SubscriptionList
 public:
     EventHandler Subscribe(EventCallbackFP callback, Subscriber subscriber = nullptr);
     EventHandler Subscribe(const EventCallback& callback, Subscriber subscriber = nullptr);
-    void Unsubscribe(EventCallbackFP fp);
-    void Unsubscribe(EventHandler handle);
-    void Unsubscribe(Subscriber subscriber);
+    bool Unsubscribe(EventCallbackFP fp); // the Unsubscribes return whether anything was removed
+    bool Unsubscribe(EventHandler handle);
+    bool Unsubscribe(Subscriber subscriber);
+    bool HasSubscriber(Subscriber subscriber) const;
     bool Dispatch(EventArgs& args) const;
 
 private:
@@ -58,7 +64,8 @@ private:
     EventHandler m_nextHandler = 1;
 };
 
-typedef std::map<std::string, SubscriptionList> EventSubscriptionMap;
+// keyed by the lowercase event name; std::less<> so FireEvent can look up a name lowercased on the stack
+typedef std::map<std::string, std::shared_ptr<const SubscriptionList>, std::less<>> EventSubscriptionMap;
 
 struct EventSystemConfig
 {
@@ -68,6 +75,7 @@ class EventSystem
 {
 public:
     EventSystem(const EventSystemConfig& theConfig);
+    ~EventSystem();
 
     // lifecycle
     void Startup();
@@ -86,10 +94,22 @@ public:
     bool FireEvent(const std::string& eventName) const;
     void GetRegisteredEventNames(std::vector<std::string>& outNames) const;
 
+private:
+    std::shared_ptr<SubscriptionList> CopyList(const EventSubscriptionMap& subscriptions, const std::string& eventName) const;
+    void PublishList(const std::string& eventName, std::shared_ptr<const SubscriptionList> list);
+    void PublishSnapshot(std::shared_ptr<const EventSubscriptionMap> subscriptions);
+
 private:
     const EventSystemConfig    m_theConfig;
-    EventSubscriptionMap       m_subscriptionListMap;
-    mutable std::mutex         m_subscriptionMutex;
+    // copy-on-write: writers build a new map (sharing every list they didn't touch) under
+    // m_subscriptionMutex and swap it in, then bump m_snapshotVersion. Each thread keeps the last
+    // snapshot it fired through, so FireEvent only reloads it after a change and otherwise takes
+    // no lock, no reference count and no allocation. A fire that ends after the subscriptions changed
+    // drops its thread's snapshot, and so does destroying the system on that thread; otherwise an
+    // idle thread keeps the snapshot of its last fire until it fires again or exits.
+    std::atomic<std::shared_ptr<const EventSubscriptionMap>> m_subscriptions;
+    std::atomic<uint64_t>      m_snapshotVersion = 0; // unique across all EventSystems
+    std::mutex                 m_subscriptionMutex;
 };
 
 class EventRecipient
@@ -0,0 +1,115 @@
+#include "Engine/Core/EventSystemBenchmark.hpp"
+
+#include "Engine/Core/DevConsole.hpp"
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Core/Time.hpp"
+
+#include <stdlib.h>
+
+
+// =================================================================================
+// =================================================================================
+static void BenchmarkPrint(const std::string& text)
+{
+	DebuggerPrintf("[EventSystemBenchmark] %s\n", text.c_str());
+	if (g_theConsole)
+		g_theConsole->AddLine(DevConsole::LOG_INFO, text);
+}
+
+static int s_numFunctionCalls = 0;
+
+static bool Event_BenchmarkFunction(EventArgs& args)
+{
+	UNUSED(args);
+	s_numFunctionCalls++;
+	return false;
+}
+
+static void PrintFireResult(const char* name, int numFires, double seconds, bool intact)
+{
+	BenchmarkPrint(Stringf("  %-16s %8.2f ms  %7.1f ns/fire  %7.2f M fires/s%s", name, seconds * 1000.0,
+		seconds * 1e9 / (double)numFires, seconds > 0.0 ? (double)numFires / seconds / 1e6 : 0.0, intact ? "" : " MISSED CALLS"));
+}
+
+
+// =================================================================================
+// =================================================================================
+void EventSystemBenchmark_Fire(int numFires, int numSubscribers)
+{
+	BenchmarkPrint(Stringf("FireEvent: %d fires, %d subscribers", numFires, numSubscribers));
+
+	EventSystemConfig config;
+	EventSystem eventSystem(config);
+
+	// every other subscriber is a capturing lambda, so the std::function path is measured too
+	int numLambdaCalls = 0;
+	int numLambdas = 0;
+	for (int idx = 0; idx < numSubscribers; idx++)
+	{
+		if (idx & 1)
+		{
+			eventSystem.Subscribe("Benchmark:Tick", [&numLambdaCalls](EventArgs&) { numLambdaCalls++; return false; });
+			numLambdas++;
+		}
+		else
+		{
+			eventSystem.SubscribeEventCallbackFunction("Benchmark:Tick", Event_BenchmarkFunction);
+		}
+	}
+
+	EventArgs args;
+	const std::string eventName = "benchmark:TICK"; // names are case-insensitive, so this goes through the same lookup as the console's
+
+	s_numFunctionCalls = 0;
+	double startTime = GetCurrentTimeSeconds();
+	for (int fire = 0; fire < numFires; fire++)
+	{
+		eventSystem.FireEvent(eventName, args);
+	}
+	double snapshotTime = GetCurrentTimeSeconds() - startTime;
+	bool intact = numLambdaCalls == numFires * numLambdas && s_numFunctionCalls == numFires * (numSubscribers - numLambdas);
+	PrintFireResult("snapshot", numFires, snapshotTime, intact);
+
+	// the old FireEvent: lock, lowercase the name, look it up, copy every subscription (std::function and all), unlock, dispatch
+	std::mutex copyMutex;
+	std::map<std::string, SubscriptionList> copyMap;
+	SubscriptionList& copySource = copyMap[tolower(eventName)];
+	for (int idx = 0; idx < numSubscribers; idx++)
+	{
+		if (idx & 1)
+			copySource.Subscribe([&numLambdaCalls](EventArgs&) { numLambdaCalls++; return false; });
+		else
+			copySource.Subscribe(Event_BenchmarkFunction);
+	}
+
+	numLambdaCalls = 0;
+	s_numFunctionCalls = 0;
+	startTime = GetCurrentTimeSeconds();
+	for (int fire = 0; fire < numFires; fire++)
+	{
+		SubscriptionList list;
+		{
+			std::lock_guard<std::mutex> guard(copyMutex);
+			auto ite = copyMap.find(tolower(eventName));
+			if (ite != copyMap.end())
+				list = ite->second;
+		}
+		list.Dispatch(args);
+	}
+	double copyTime = GetCurrentTimeSeconds() - startTime;
+	intact = numLambdaCalls == numFires * numLambdas && s_numFunctionCalls == numFires * (numSubscribers - numLambdas);
+	PrintFireResult("copy under lock", numFires, copyTime, intact);
+
+	BenchmarkPrint(Stringf("  snapshot speedup x%.2f", snapshotTime > 0.0 ? copyTime / snapshotTime : 0.0));
+}
+
+bool Command_EventSystemBenchmark(EventArgs& args)
+{
+	int fires = atoi(args.GetValue("fires", "1000000").c_str());
+	int subscribers = atoi(args.GetValue("subscribers", "10").c_str());
+
+	EventSystemBenchmark_Fire(fires > 0 ? fires : 1, subscribers >= 0 ? subscribers : 0);
+	return true;
+}
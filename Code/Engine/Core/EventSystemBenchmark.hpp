@@ -0,0 +1,17 @@
+#pragma once
+
+#include "Engine/Core/EventSystem.hpp"
+
+
+// =================================================================================
+// Cost of EventSystem::FireEvent on a hot event: a private EventSystem with a mix
+// of function pointer and lambda subscribers, fired in a tight loop, next to the
+// same loop copying the subscriber list under a lock on every fire (what FireEvent
+// did before subscription snapshots). Results go to the DevConsole (if any) and
+// the debugger output.
+//
+// Console: EventSystemBenchmark fires=1000000 subscribers=10
+// =================================================================================
+void EventSystemBenchmark_Fire(int numFires, int numSubscribers);
+
+bool Command_EventSystemBenchmark(EventArgs& args);
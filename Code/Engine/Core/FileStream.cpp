@@ -0,0 +1,225 @@
+#include "Engine/Core/FileStream.hpp"
+
+#include "Engine/Core/ErrorWarningAssert.hpp"
+
+#include <string.h>
+
+
+// =============================================================================================
+// =============================================================================================
+static size_t RoundChunkSize(size_t chunkSize)
+{
+	// chunks start on 4 byte boundaries of the file, so Read/WriteAlignment inside a chunk match the file's
+	if (chunkSize < 4096)
+		chunkSize = 4096;
+	return (chunkSize + 3) & ~(size_t)3;
+}
+
+
+// =============================================================================================
+// =============================================================================================
+StreamingFileReader::StreamingFileReader(JobSystem& system, size_t chunkSize)
+	: m_system(system)
+	, m_chunkSize(RoundChunkSize(chunkSize))
+{
+	m_buffers[0].EnsureWritable(m_chunkSize);
+	m_buffers[1].EnsureWritable(m_chunkSize);
+}
+
+StreamingFileReader::~StreamingFileReader()
+{
+	Close();
+}
+
+bool StreamingFileReader::Open(const std::string& filename)
+{
+	Close();
+
+	m_file.open(filename, std::ios::in | std::ios::binary);
+	if (!m_file.is_open())
+		return false;
+
+	m_file.seekg(0, m_file.end);
+	m_fileSize = (size_t)m_file.tellg();
+	m_file.seekg(0, m_file.beg);
+
+	m_isOpen = true;
+	m_endOfFile = false;
+	m_failed = false;
+	m_chunk = ByteBufferView();
+	Prefetch();
+	return true;
+}
+
+void StreamingFileReader::Close()
+{
+	// the io job may still be reading into the back buffer
+	m_system.Wait(m_pendingRead);
+
+	if (m_file.is_open())
+		m_file.close();
+	m_file.clear();
+	m_buffers[0].Reset();
+	m_buffers[1].Reset();
+	m_chunk = ByteBufferView();
+	m_fileSize = 0;
+	m_isOpen = false;
+}
+
+bool StreamingFileReader::NextChunk(ByteBufferView& outChunk)
+{
+	if (!m_isOpen)
+		return false;
+
+	m_system.Wait(m_pendingRead);
+
+	ByteBuffer& prefetched = m_buffers[1 - m_frontBuffer];
+	if (HasFailed() || prefetched.GetReadableSize() == 0)
+	{
+		m_chunk = ByteBufferView();
+		outChunk = m_chunk;
+		return false;
+	}
+
+	// the caller is done with the old front buffer, the next read goes there
+	m_frontBuffer = 1 - m_frontBuffer;
+	m_chunk = prefetched.Slice();
+	outChunk = m_chunk;
+	Prefetch();
+	return true;
+}
+
+size_t StreamingFileReader::Read(size_t size, void* data)
+{
+	BYTE* dst = (BYTE*)data;
+	size_t numRead = 0;
+	while (numRead < size)
+	{
+		if (m_chunk.GetReadableSize() == 0)
+		{
+			ByteBufferView chunk;
+			if (!NextChunk(chunk))
+				break;
+		}
+		numRead += m_chunk.Read(size - numRead, &dst[numRead]);
+	}
+	return numRead;
+}
+
+void StreamingFileReader::Prefetch()
+{
+	ByteBuffer& back = m_buffers[1 - m_frontBuffer];
+	back.Reset();
+	if (m_endOfFile)
+		return;
+
+	m_pendingRead.Add();
+	m_system.QueueLambda([this, &back]()
+		{
+			m_file.read((char*)back.data(), m_chunkSize);
+			back.m_writeIdx = (size_t)m_file.gcount();
+			if (back.m_writeIdx < m_chunkSize)
+			{
+				if (!m_file.eof())
+					m_failed.store(true, std::memory_order_release);
+				m_endOfFile = true;
+			}
+			m_pendingRead.Done();
+		}, JobPriority::NORMAL, JobLane::IO);
+}
+
+
+// =============================================================================================
+// =============================================================================================
+StreamingFileWriter::StreamingFileWriter(JobSystem& system, size_t chunkSize)
+	: m_system(system)
+	, m_chunkSize(RoundChunkSize(chunkSize))
+{
+	m_buffers[0].EnsureWritable(m_chunkSize);
+	m_buffers[1].EnsureWritable(m_chunkSize);
+}
+
+StreamingFileWriter::~StreamingFileWriter()
+{
+	Close();
+}
+
+bool StreamingFileWriter::Open(const std::string& filename)
+{
+	Close();
+
+	m_file.open(filename, std::ios::out | std::ios::trunc | std::ios::binary);
+	if (!m_file.is_open())
+		return false;
+
+	m_isOpen = true;
+	m_failed = false;
+	m_numBytesWritten = 0;
+	return true;
+}
+
+bool StreamingFileWriter::Close()
+{
+	if (m_isOpen)
+	{
+		// the last chunk goes out whole, alignment no longer matters
+		m_system.Wait(m_pendingWrite);
+		ByteBuffer& front = m_buffers[m_frontBuffer];
+		m_file.write((const char*)front.data(), front.m_writeIdx);
+		m_file.close();
+		if (m_file.fail())
+			m_failed = true;
+	}
+
+	m_system.Wait(m_pendingWrite);
+	m_buffers[0].Reset();
+	m_buffers[1].Reset();
+	m_isOpen = false;
+	return !HasFailed();
+}
+
+void StreamingFileWriter::Write(size_t size, const void* data)
+{
+	const BYTE* src = (const BYTE*)data;
+	m_numBytesWritten += size;
+	while (size)
+	{
+		ByteBuffer& front = m_buffers[m_frontBuffer];
+		size_t room = m_chunkSize > front.m_writeIdx ? m_chunkSize - front.m_writeIdx : 0;
+		size_t copySize = size < room ? size : room;
+		front.Write(copySize, src);
+		src += copySize;
+		size -= copySize;
+
+		if (front.m_writeIdx >= m_chunkSize)
+			Flush();
+	}
+}
+
+void StreamingFileWriter::Flush()
+{
+	GUARANTEE_OR_DIE(m_isOpen, "StreamingFileWriter: writing without an open file");
+
+	// the back buffer is free once its write is done
+	m_system.Wait(m_pendingWrite);
+
+	ByteBuffer& full = m_buffers[m_frontBuffer];
+	m_frontBuffer = 1 - m_frontBuffer;
+	ByteBuffer& next = m_buffers[m_frontBuffer];
+	next.Reset();
+
+	// whole 4 byte groups only, the rest starts the next chunk so alignment in it matches the file's
+	size_t flushSize = full.m_writeIdx & ~(size_t)3;
+	next.Write(full.m_writeIdx - flushSize, &full.data()[flushSize]);
+	full.m_writeIdx = flushSize;
+
+	m_pendingWrite.Add();
+	m_system.QueueLambda([this, &full]()
+		{
+			m_file.write((const char*)full.data(), full.m_writeIdx);
+			if (m_file.fail())
+				m_failed.store(true, std::memory_order_release);
+			m_pendingWrite.Done();
+		}, JobPriority::NORMAL, JobLane::IO);
+}
+
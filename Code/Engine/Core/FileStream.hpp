@@ -0,0 +1,122 @@
+#pragma once
+
+#include "Engine/Core/ByteBuffer.hpp"
+#include "Engine/Core/JobSystem.hpp"
+
+#include <atomic>
+#include <fstream>
+#include <string>
+
+
+// =============================================================================================
+// Reads a file front to back in fixed-size chunks, double buffered: while the caller parses one
+// chunk, an io job reads the next one into the other buffer. Only two chunks are ever in memory,
+// so files bigger than memory work too.
+//
+//     StreamingFileReader reader(*g_theJobSystem);
+//     reader.Open("Data/Capture.pcap");
+//     ByteBufferView chunk;
+//     while (reader.NextChunk(chunk))
+//         Parse(chunk);
+// =============================================================================================
+class StreamingFileReader
+{
+public:
+	static constexpr size_t DEFAULT_CHUNK_SIZE = 1024 * 1024;
+
+public:
+	explicit StreamingFileReader(JobSystem& system, size_t chunkSize = DEFAULT_CHUNK_SIZE);
+	~StreamingFileReader(); // closes
+
+	StreamingFileReader(const StreamingFileReader&) = delete;
+	void operator=(const StreamingFileReader&) = delete;
+
+	bool   Open(const std::string& filename); // starts reading the first chunk right away
+	void   Close();
+
+	// The next chunk, waiting for it if the io job isn't done yet, and starts reading the one after.
+	// The view is valid until the next call; false at the end of the file or on a read error.
+	bool   NextChunk(ByteBufferView& outChunk);
+
+	// Byte-wise reading across chunk boundaries, e.g. for records that straddle two chunks
+	size_t Read(size_t size, void* data);
+
+	bool   IsOpen() const                      { return m_isOpen; }
+	bool   HasFailed() const                   { return m_failed.load(std::memory_order_acquire); }
+	size_t GetFileSize() const                 { return m_fileSize; }
+
+private:
+	void   Prefetch(); // queues the read of the next chunk into the back buffer
+
+private:
+	JobSystem&           m_system;
+	size_t               m_chunkSize;
+	std::ifstream        m_file; // only touched by the io job while a read is in flight
+	ByteBuffer           m_buffers[2];
+	int                  m_frontBuffer = 0;
+	ByteBufferView       m_chunk; // what Read consumes
+	JobCounter           m_pendingRead;
+	size_t               m_fileSize = 0;
+	bool                 m_isOpen = false;
+	bool                 m_endOfFile = false;
+	std::atomic_bool     m_failed = false;
+};
+
+
+// =============================================================================================
+// The other way: writes gather in a chunk-sized buffer, full chunks go to the file on an io job
+// while the caller fills the other buffer. Write only waits when the caller outpaces the disk.
+// =============================================================================================
+class StreamingFileWriter
+{
+public:
+	static constexpr size_t DEFAULT_CHUNK_SIZE = 1024 * 1024;
+
+public:
+	explicit StreamingFileWriter(JobSystem& system, size_t chunkSize = DEFAULT_CHUNK_SIZE);
+	~StreamingFileWriter(); // closes
+
+	StreamingFileWriter(const StreamingFileWriter&) = delete;
+	void operator=(const StreamingFileWriter&) = delete;
+
+	bool   Open(const std::string& filename);
+	bool   Close(); // flushes the rest and waits for it; false if any write failed
+
+	void   Write(size_t size, const void* data);
+	template<typename T>
+	void   WriteObject(const T& object); // anything with WriteBytes(ByteBuffer*)
+
+	bool   IsOpen() const                      { return m_isOpen; }
+	bool   HasFailed() const                   { return m_failed.load(std::memory_order_acquire); }
+	size_t GetNumBytesWritten() const          { return m_numBytesWritten; }
+
+private:
+	void   Flush(); // hands the front buffer to an io job, waiting for the previous one first
+
+private:
+	JobSystem&           m_system;
+	size_t               m_chunkSize;
+	std::ofstream        m_file; // only touched by the io job while a write is in flight
+	ByteBuffer           m_buffers[2];
+	int                  m_frontBuffer = 0;
+	JobCounter           m_pendingWrite;
+	size_t               m_numBytesWritten = 0;
+	bool                 m_isOpen = false;
+	std::atomic_bool     m_failed = false;
+};
+
+
+// =============================================================================================
+// =================================   INLINE FUNCTIONS   ======================================
+// =============================================================================================
+template<typename T>
+void StreamingFileWriter::WriteObject(const T& object)
+{
+	ByteBuffer& front = m_buffers[m_frontBuffer];
+	size_t prevWriteIdx = front.m_writeIdx;
+	object.WriteBytes(&front);
+	m_numBytesWritten += front.m_writeIdx - prevWriteIdx;
+	if (front.m_writeIdx >= m_chunkSize)
+		Flush();
+}
+
@@ -5,6 +5,18 @@
 #include <iterator>
 
 #include "Engine/Core/ByteBuffer.hpp"
+#include "Engine/Core/ByteBufferPool.hpp"
+#include "Engine/Core/ByteCompression.hpp"
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#elif defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 bool FileExists(const std::string& filename)
 {
@@ -26,14 +38,30 @@ int FileWriteFromBuffer(std::vector<uint8_t>& inBuffer, const std::string& filen
 	}
 }
 
-int FileWriteFromBuffer(ByteBuffer& inBuffer, const std::string& filename)
+int FileWriteFromBuffer(ByteBuffer& inBuffer, const std::string& filename, bool appendChecksum)
 {
 	std::ofstream file(filename, std::ios::out | std::ios::trunc | std::ios::binary);
 	if (file.is_open())
 	{
-		size_t length = inBuffer.m_writeIdx - inBuffer.m_readIdx;
-		file.write((const char*)&inBuffer.data()[inBuffer.m_readIdx], length);
-		inBuffer.m_readIdx += length;
+		// straight from each segment, no joining copy
+		size_t length = 0;
+		uint32_t crc = 0;
+		for (const ByteBufferView& segment : inBuffer.GetSegments())
+		{
+			file.write((const char*)&segment.data()[segment.m_readIdx], segment.GetReadableSize());
+			length += segment.GetReadableSize();
+			if (appendChecksum)
+				crc = Crc32c(segment, crc);
+		}
+		if (appendChecksum)
+		{
+			ByteBufferLease footer = ByteBufferPool::GetShared().Acquire(CHECKSUM_FOOTER_SIZE);
+			WriteChecksumFooter(*footer, length, crc);
+			file.write((const char*)footer->data(), footer->m_writeIdx);
+			length += footer->m_writeIdx;
+		}
+		inBuffer.ReleaseSegments();
+		inBuffer.m_readIdx = inBuffer.m_writeIdx;
 		return (int)length;
 	}
 	else
@@ -87,8 +115,12 @@ int FileReadToBuffer(ByteBuffer& outBuffer, const std::string& filename)
 
 		outBuffer.EnsureWritable(size);
 		file.read((char*)&outBuffer.data()[outBuffer.m_writeIdx], size);
-		outBuffer.m_writeIdx += size;
-		return (int)size;
+
+		ByteBufferView contents(&outBuffer.data()[outBuffer.m_writeIdx], size);
+		if (StripChecksumFooter(contents) == ChecksumFooter::CORRUPT)
+			return -1;
+		outBuffer.m_writeIdx += contents.m_writeIdx;
+		return (int)contents.m_writeIdx;
 	}
 	else
 	{
@@ -117,3 +149,208 @@ int FileReadToString(std::string& outString, const std::string& filename)
 	}
 }
 
+int FileWriteFromBufferCompressed(ByteBuffer& inBuffer, const std::string& filename, bool appendChecksum)
+{
+	std::ofstream file(filename, std::ios::out | std::ios::trunc | std::ios::binary);
+	if (file.is_open())
+	{
+		// one block of output at a time, the compressed copy never exists whole
+		ByteBufferLease compressed = ByteBufferPool::GetShared().Acquire(COMPRESSION_BLOCK_SIZE * 2);
+		ByteCompressor compressor(compressed.Get());
+		size_t length = 0;
+		uint32_t crc = 0;
+		auto drain = [&]()
+			{
+				file.write((const char*)&compressed->data()[compressed->m_readIdx], compressed->GetReadableSize());
+				length += compressed->GetReadableSize();
+				if (appendChecksum)
+					crc = Crc32c(compressed->Slice(), crc);
+				compressed->Reset();
+			};
+
+		for (const ByteBufferView& segment : inBuffer.GetSegments())
+		{
+			for (size_t offset = 0; offset < segment.GetReadableSize(); offset += COMPRESSION_BLOCK_SIZE)
+			{
+				compressor.Write(segment.Slice(offset, COMPRESSION_BLOCK_SIZE));
+				drain();
+			}
+		}
+		compressor.Finish();
+		drain();
+
+		if (appendChecksum)
+		{
+			WriteChecksumFooter(*compressed, length, crc);
+			file.write((const char*)compressed->data(), compressed->m_writeIdx);
+			length += compressed->m_writeIdx;
+		}
+
+		inBuffer.ReleaseSegments();
+		inBuffer.m_readIdx = inBuffer.m_writeIdx;
+		return (int)length;
+	}
+	else
+	{
+		return -1;
+	}
+}
+
+int FileReadToBufferCompressed(ByteBuffer& outBuffer, const std::string& filename)
+{
+	// mapped, the footer is at the end and has to be checked before decoding anything
+	MappedFile file(filename);
+	if (file.IsOpen())
+	{
+		ByteBufferView contents = file.GetView();
+		if (StripChecksumFooter(contents) == ChecksumFooter::CORRUPT)
+			return -1;
+
+		size_t prevSize = outBuffer.GetTotalSize();
+		ByteDecompressor decompressor(&outBuffer);
+		if (!decompressor.Feed(contents) || !decompressor.IsFinished())
+			return -1;
+		return (int)(outBuffer.GetTotalSize() - prevSize);
+	}
+	else
+	{
+		return -1;
+	}
+}
+
+MappedFile::MappedFile(const std::string& filename, bool allowMapping)
+{
+	Open(filename, allowMapping);
+}
+
+MappedFile::MappedFile(MappedFile&& moveFrom) noexcept
+{
+	*this = std::move(moveFrom);
+}
+
+MappedFile::~MappedFile()
+{
+	Close();
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& moveFrom) noexcept
+{
+	if (this != &moveFrom)
+	{
+		Close();
+		m_data = moveFrom.m_data;
+		m_size = moveFrom.m_size;
+		m_isOpen = moveFrom.m_isOpen;
+		m_mapping = moveFrom.m_mapping;
+		m_mappingHandle = moveFrom.m_mappingHandle;
+		m_fallback = std::move(moveFrom.m_fallback);
+
+		moveFrom.m_data = nullptr;
+		moveFrom.m_size = 0;
+		moveFrom.m_isOpen = false;
+		moveFrom.m_mapping = nullptr;
+		moveFrom.m_mappingHandle = nullptr;
+	}
+	return *this;
+}
+
+bool MappedFile::Open(const std::string& filename, bool allowMapping)
+{
+	Close();
+
+#if defined(_WIN32)
+	if (allowMapping)
+	{
+		HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (file == INVALID_HANDLE_VALUE)
+			return false;
+
+		LARGE_INTEGER size = {};
+		GetFileSizeEx(file, &size);
+		if (size.QuadPart == 0)
+		{
+			// nothing to map, an empty file is still a file
+			CloseHandle(file);
+			m_isOpen = true;
+			return true;
+		}
+
+		// the mapping keeps the file open on its own
+		HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		CloseHandle(file);
+		void* view = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+		if (view)
+		{
+			m_mapping = view;
+			m_mappingHandle = mapping;
+			m_data = (const BYTE*)view;
+			m_size = (size_t)size.QuadPart;
+			m_isOpen = true;
+			return true;
+		}
+		if (mapping)
+			CloseHandle(mapping);
+	}
+#elif defined(__unix__) || defined(__APPLE__)
+	if (allowMapping)
+	{
+		int file = open(filename.c_str(), O_RDONLY);
+		if (file < 0)
+			return false;
+
+		struct stat status = {};
+		fstat(file, &status);
+		if (status.st_size == 0)
+		{
+			close(file);
+			m_isOpen = true;
+			return true;
+		}
+
+		void* view = mmap(nullptr, (size_t)status.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+		close(file);
+		if (view != MAP_FAILED)
+		{
+			m_mapping = view;
+			m_data = (const BYTE*)view;
+			m_size = (size_t)status.st_size;
+			m_isOpen = true;
+			return true;
+		}
+	}
+#endif
+
+	// no mapping here, read it the usual way
+	if (FileReadToBuffer(m_fallback, filename) < 0)
+		return false;
+	m_data = m_fallback.data();
+	m_size = m_fallback.size();
+	m_isOpen = true;
+	return true;
+}
+
+void MappedFile::Close()
+{
+#if defined(_WIN32)
+	if (m_mapping)
+		UnmapViewOfFile(m_mapping);
+	if (m_mappingHandle)
+		CloseHandle((HANDLE)m_mappingHandle);
+#elif defined(__unix__) || defined(__APPLE__)
+	if (m_mapping)
+		munmap(m_mapping, m_size);
+#endif
+
+	m_data = nullptr;
+	m_size = 0;
+	m_isOpen = false;
+	m_mapping = nullptr;
+	m_mappingHandle = nullptr;
+	m_fallback.clear();
+	m_fallback.shrink_to_fit();
+}
+
+ByteBufferView MappedFile::GetView() const
+{
+	return ByteBufferView(m_data, m_size);
+}
@@ -1,12 +1,81 @@
+#pragma once
+
+#include "Engine/Core/ByteBuffer.hpp"
+#include "Engine/Core/ByteBufferPool.hpp"
+#include "Engine/Core/Checksum.hpp"
+
 #include <string>
 #include <vector>
 
-class ByteBuffer;
-
 bool FileExists(const std::string& filename);
-int  FileWriteFromBuffer(ByteBuffer& inBuffer, const std::string& filename);
+int  FileWriteFromBuffer(ByteBuffer& inBuffer, const std::string& filename, bool appendChecksum = false);
 int  FileWriteFromBuffer(std::vector<uint8_t>& inBuffer, const std::string& filename);
 int  FileWriteFromString(std::string& inString, const std::string& filename);
-int  FileReadToBuffer(ByteBuffer& outBuffer, const std::string& filename);
+int  FileReadToBuffer(ByteBuffer& outBuffer, const std::string& filename); // checks and strips a checksum footer, -1 if it doesn't match
 int  FileReadToBuffer(std::vector<uint8_t>& outBuffer, const std::string& filename);
 int  FileReadToString(std::string& outString, const std::string& filename);
+
+// Same as the plain ones with ByteCompression in between; the write returns the bytes on disk, the
+// read the bytes decompressed into outBuffer, -1 for a missing or corrupt file. The checksum footer
+// covers the compressed bytes, so a damaged file is caught before decompressing it.
+int  FileWriteFromBufferCompressed(ByteBuffer& inBuffer, const std::string& filename, bool appendChecksum = false);
+int  FileReadToBufferCompressed(ByteBuffer& outBuffer, const std::string& filename);
+
+
+// Read-only contents of a whole file, memory mapped where the platform can, read into memory
+// otherwise (or when mapping fails, e.g. on some network drives). Views from GetView point into
+// the mapping and are valid until the MappedFile is closed or destroyed, so assets can be parsed
+// in place without a copy of the file.
+class MappedFile
+{
+public:
+	MappedFile() = default;
+	explicit MappedFile(const std::string& filename, bool allowMapping = true);
+	MappedFile(const MappedFile& copyFrom) = delete;
+	MappedFile(MappedFile&& moveFrom) noexcept;
+	~MappedFile();
+
+	MappedFile& operator=(MappedFile&& moveFrom) noexcept;
+
+	bool           Open(const std::string& filename, bool allowMapping = true);
+	void           Close();
+
+	bool           IsOpen() const       { return m_isOpen; }
+	bool           IsMapped() const     { return m_mapping != nullptr; }
+	size_t         GetSize() const      { return m_size; }
+	const BYTE*    data() const         { return m_data; }
+	ByteBufferView GetView() const;
+
+private:
+	const BYTE*           m_data = nullptr;
+	size_t                m_size = 0;
+	bool                  m_isOpen = false;
+	void*                 m_mapping = nullptr; // platform handles of the mapped view
+	void*                 m_mappingHandle = nullptr;
+	std::vector<uint8_t>  m_fallback; // buffered read
+};
+
+// Parses anything with ReadBytes(ByteBufferView*) (Mesh, Skeleton, Animation, ...) straight out of the
+// file; false for a missing file or one whose checksum footer doesn't match
+template<typename T>
+bool FileReadObject(T& object, const std::string& filename)
+{
+	MappedFile file(filename);
+	if (!file.IsOpen())
+		return false;
+
+	ByteBufferView view = file.GetView();
+	if (StripChecksumFooter(view) == ChecksumFooter::CORRUPT)
+		return false;
+	object.ReadBytes(&view);
+	return true;
+}
+
+// The other way, serialized through a pooled buffer so cooking many assets doesn't allocate one each
+template<typename T>
+int FileWriteObject(const T& object, const std::string& filename, bool appendChecksum = false)
+{
+	ByteBufferLease buffer = ByteBufferPool::GetShared().Acquire();
+	object.WriteBytes(buffer.Get());
+	return FileWriteFromBuffer(*buffer, filename, appendChecksum);
+}
@@ -204,6 +204,42 @@ void IOBuffer::write(size_t size, const void* src)
     m_buffer.Write(size, (const BYTE*)src);
 }
 
+size_t IOBuffer::readArray(size_t count, void* dst, int width)
+{
+    size_t size = count * width;
+    if (size > m_buffer.GetReadableSize())
+        size = m_buffer.GetReadableSize() - m_buffer.GetReadableSize() % width;
+
+    if (!m_flipEndian)
+    {
+        m_buffer.Read(size, (BYTE*)dst);
+        return size / width;
+    }
+
+    ByteUtils::CopyReverseBytes(dst, &m_buffer.data()[m_buffer.m_readIdx], size / width, width);
+    m_buffer.m_readIdx += size;
+    return size / width;
+}
+
+void IOBuffer::writeArray(size_t count, const void* src, int width)
+{
+    size_t size = count * width;
+    if (!m_flipEndian)
+    {
+        m_buffer.Write(size, (const BYTE*)src);
+        return;
+    }
+
+    m_buffer.EnsureWritable(size);
+    ByteUtils::CopyReverseBytes(&m_buffer.data()[m_buffer.m_writeIdx], src, count, width);
+    m_buffer.m_writeIdx += size;
+}
+
+bool IOBuffer::isFlippingEndian() const
+{
+    return m_flipEndian;
+}
+
 void IOBuffer::flip16(void* val)
 {
     if (!m_flipEndian)
@@ -40,6 +40,12 @@ public:
 	void skip(size_t size); // for read
 	void read(size_t size, void* dst);
 	void write(size_t size, const void* src);
+	// count elements of width (2, 4 or 8) bytes, flipped like the scalar reads and writes: a plain
+	// copy when the endianness matches, the vectorized ByteUtils swap otherwise. readArray returns
+	// the elements read, fewer than count when the buffer runs out
+	size_t readArray(size_t count, void* dst, int width);
+	void writeArray(size_t count, const void* src, int width);
+	bool isFlippingEndian() const;
 
 private:
 	void flip16(void* val);
@@ -50,5 +56,5 @@ public:
 	ByteBuffer m_buffer;
 
 private:
-	bool m_flipEndian;
+	bool m_flipEndian = false;
 };
@@ -0,0 +1,143 @@
+#include "Engine/Core/JobCoroutine.hpp"
+
+#if defined(__cpp_impl_coroutine)
+
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/FileUtils.hpp"
+
+
+// =============================================================================================
+// Resumes a suspended coroutine. Once the resume job is queued the coroutine may run (and
+// finish) on another thread right away, so awaiters must not touch themselves afterwards.
+// =============================================================================================
+static Job* CreateResumeJob(std::coroutine_handle<> handle, JobPriority priority = JobPriority::NORMAL, JobLane lane = JobLane::COMPUTE)
+{
+	return new LambdaJob([handle]() { handle.resume(); }, 0, priority, lane);
+}
+
+
+// =============================================================================================
+// =============================================================================================
+JobTask JobTask::promise_type::get_return_object()
+{
+	return JobTask(std::coroutine_handle<promise_type>::from_promise(*this));
+}
+
+void JobTask::promise_type::return_void()
+{
+	if (m_done)
+		m_done->Done();
+}
+
+void JobTask::promise_type::unhandled_exception()
+{
+	ERROR_AND_DIE("JobTask: unhandled exception in job coroutine");
+}
+
+JobTask::JobTask(JobTask&& other) noexcept
+	: m_handle(other.m_handle)
+{
+	other.m_handle = nullptr;
+}
+
+JobTask& JobTask::operator=(JobTask&& other) noexcept
+{
+	if (this != &other)
+	{
+		if (m_handle)
+			m_handle.destroy();
+		m_handle = other.m_handle;
+		other.m_handle = nullptr;
+	}
+	return *this;
+}
+
+JobTask::~JobTask()
+{
+	// never started
+	if (m_handle)
+		m_handle.destroy();
+}
+
+JobHandle StartCoroutine(JobSystem& system, JobTask task, JobPriority priority /*= JobPriority::NORMAL*/)
+{
+	GUARANTEE_OR_DIE(task.m_handle, "StartCoroutine: task is empty or already started");
+
+	JobHandle done = std::make_shared<JobCounter>(1);
+	task.m_handle.promise().m_done = done;
+
+	std::coroutine_handle<> handle = task.m_handle;
+	task.m_handle = nullptr; // the frame owns itself from here on
+	system.QueueJob(CreateResumeJob(handle, priority));
+	return done;
+}
+
+
+// =============================================================================================
+// =============================================================================================
+SwitchToAwaiter SwitchTo(JobSystem& system, JobLane lane, JobPriority priority /*= JobPriority::NORMAL*/)
+{
+	return SwitchToAwaiter{ system, lane, priority };
+}
+
+void SwitchToAwaiter::await_suspend(std::coroutine_handle<> handle)
+{
+	m_system.QueueJob(CreateResumeJob(handle, m_priority, m_lane));
+}
+
+
+// =============================================================================================
+// =============================================================================================
+JobAwaiter AwaitJob(JobSystem& system, Job* job)
+{
+	return JobAwaiter{ system, job };
+}
+
+void JobAwaiter::await_suspend(std::coroutine_handle<> handle)
+{
+	JobSystem& system = m_system;
+	Job* job = m_job;
+
+	// the resume job is a continuation, it is scheduled on the worker that finished the job
+	Job* resumeJob = CreateResumeJob(handle, job->m_priority);
+	resumeJob->AddDependency(job);
+	system.QueueJob(resumeJob);
+	system.QueueJob(job);
+}
+
+
+// =============================================================================================
+// =============================================================================================
+ReadFileAwaiter ReadFileAsync(JobSystem& system, ByteBuffer& outBuffer, const std::string& filename)
+{
+	return ReadFileAwaiter{ system, outBuffer, filename };
+}
+
+void ReadFileAwaiter::await_suspend(std::coroutine_handle<> handle)
+{
+	// the awaiter lives in the suspended frame, it stays valid until the resume job runs
+	m_system.QueueLambda([this, handle]()
+		{
+			m_result = FileReadToBuffer(m_buffer, m_filename);
+
+			JobSystem& system = m_system;
+			system.QueueJob(CreateResumeJob(handle));
+		}, JobPriority::NORMAL, JobLane::IO);
+}
+
+
+// =============================================================================================
+// =============================================================================================
+NextFrameAwaiter NextFrame(JobSystem& system)
+{
+	return NextFrameAwaiter{ system };
+}
+
+void NextFrameAwaiter::await_suspend(std::coroutine_handle<> handle)
+{
+	m_system.QueueJobNextFrame(CreateResumeJob(handle));
+}
+
+
+#endif // __cpp_impl_coroutine
+
@@ -0,0 +1,139 @@
+#pragma once
+
+#include "Engine/Core/JobSystem.hpp"
+
+// C++20 only, the header is empty for projects still on C++17
+#if defined(__cpp_impl_coroutine)
+
+#include <coroutine>
+#include <string>
+
+
+// =============================================================================================
+// Multi-step async work as one function. A suspended coroutine is just its frame, it holds no
+// worker; every co_await hands the rest of the function to the JobSystem as a new job.
+//
+//     JobTask LoadTexture(JobSystem& jobs, std::string path)
+//     {
+//         ByteBuffer file;
+//         co_await ReadFileAsync(jobs, file, path);   // io worker, then back on a compute worker
+//         Image image = DecodeImage(file);              // compute worker
+//         co_await NextFrame(jobs);                     // main thread, in JobSystem::BeginFrame
+//         CreateTexture(image);
+//     }
+//
+//     JobHandle done = StartCoroutine(jobs, LoadTexture(jobs, path));
+// =============================================================================================
+class ByteBuffer;
+
+
+// =============================================================================================
+// Return type of a job coroutine. Starts suspended, StartCoroutine schedules it.
+// =============================================================================================
+class JobTask
+{
+public:
+	struct promise_type
+	{
+		JobTask                  get_return_object();
+		std::suspend_always      initial_suspend() noexcept     { return {}; }
+		std::suspend_never       final_suspend() noexcept       { return {}; } // frame frees itself at the end
+		void                     return_void();
+		void                     unhandled_exception();
+
+		JobHandle                m_done;
+	};
+
+public:
+	JobTask() = default;
+	JobTask(JobTask&& other) noexcept;
+	JobTask& operator=(JobTask&& other) noexcept;
+	~JobTask();
+
+	JobTask(const JobTask&) = delete;
+	void operator=(const JobTask&) = delete;
+
+private:
+	explicit JobTask(std::coroutine_handle<promise_type> handle) : m_handle(handle) {}
+
+	friend JobHandle StartCoroutine(JobSystem& system, JobTask task, JobPriority priority);
+
+private:
+	std::coroutine_handle<promise_type> m_handle;
+};
+
+// Runs the coroutine on a compute worker, the handle is done when the coroutine returns
+JobHandle StartCoroutine(JobSystem& system, JobTask task, JobPriority priority = JobPriority::NORMAL);
+
+
+// =============================================================================================
+// co_await SwitchTo(jobs, lane): continue on a worker of the lane
+// =============================================================================================
+struct SwitchToAwaiter
+{
+	bool     await_ready() const noexcept                   { return false; }
+	void     await_suspend(std::coroutine_handle<> handle);
+	void     await_resume() const noexcept                  {}
+
+	JobSystem&       m_system;
+	JobLane          m_lane;
+	JobPriority      m_priority;
+};
+
+SwitchToAwaiter SwitchTo(JobSystem& system, JobLane lane, JobPriority priority = JobPriority::NORMAL);
+
+
+// =============================================================================================
+// co_await AwaitJob(jobs, job): queue an unqueued job and continue on the worker that executed it.
+// The job is still finished up by FinishUpJobs as usual, keep m_destroyAfterFinished false to read
+// its results afterwards.
+// =============================================================================================
+struct JobAwaiter
+{
+	bool     await_ready() const noexcept                   { return false; }
+	void     await_suspend(std::coroutine_handle<> handle);
+	void     await_resume() const noexcept                  {}
+
+	JobSystem&       m_system;
+	Job*             m_job;
+};
+
+JobAwaiter AwaitJob(JobSystem& system, Job* job);
+
+
+// =============================================================================================
+// co_await ReadFileAsync(jobs, buffer, filename): read on an io worker, continue on a compute
+// worker. Returns what FileReadToBuffer returned.
+// =============================================================================================
+struct ReadFileAwaiter
+{
+	bool     await_ready() const noexcept                   { return false; }
+	void     await_suspend(std::coroutine_handle<> handle);
+	int      await_resume() const noexcept                  { return m_result; }
+
+	JobSystem&       m_system;
+	ByteBuffer&      m_buffer;
+	std::string      m_filename;
+	int              m_result = 0;
+};
+
+ReadFileAwaiter ReadFileAsync(JobSystem& system, ByteBuffer& outBuffer, const std::string& filename);
+
+
+// =============================================================================================
+// co_await NextFrame(jobs): continue on the main thread at the next JobSystem::BeginFrame
+// =============================================================================================
+struct NextFrameAwaiter
+{
+	bool     await_ready() const noexcept                   { return false; }
+	void     await_suspend(std::coroutine_handle<> handle);
+	void     await_resume() const noexcept                  {}
+
+	JobSystem&       m_system;
+};
+
+NextFrameAwaiter NextFrame(JobSystem& system);
+
+
+#endif // __cpp_impl_coroutine
+
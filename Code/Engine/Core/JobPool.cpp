@@ -0,0 +1,148 @@
+#include "Engine/Core/JobPool.hpp"
+
+#include <mutex>
+#include <new>
+
+
+// =============================================================================================
+// pools of exited threads, adopted by new threads instead of being freed, their blocks may still be in flight
+// =============================================================================================
+static std::mutex             s_idlePoolsLock;
+static std::vector<JobPool*>  s_idlePools;
+
+struct JobPoolThreadHolder
+{
+	~JobPoolThreadHolder()
+	{
+		if (m_pool)
+			JobPool::ReleaseThreadPool(m_pool);
+	}
+
+	JobPool*  m_pool = nullptr;
+};
+
+static thread_local JobPoolThreadHolder s_threadPool;
+
+std::atomic<int64_t> JobPool::s_numHeapAllocations = 0;
+
+
+// =============================================================================================
+// =============================================================================================
+void* JobPool::Allocate(size_t size)
+{
+	if (size > BLOCK_SIZE)
+	{
+		// too big to pool, still goes through a header so Free can tell the difference
+		s_numHeapAllocations++;
+		Block* block = (Block*) ::operator new(BLOCK_HEADER_SIZE + size);
+		block->m_owner = nullptr;
+		return (unsigned char*)block + BLOCK_HEADER_SIZE;
+	}
+	return GetThreadPool()->AllocateBlock();
+}
+
+void JobPool::Free(void* memory)
+{
+	if (!memory)
+		return;
+
+	Block* block = (Block*)((unsigned char*)memory - BLOCK_HEADER_SIZE);
+	if (!block->m_owner)
+	{
+		::operator delete(block);
+		return;
+	}
+	block->m_owner->FreeBlock(block);
+}
+
+void JobPool::Reclaim()
+{
+	GetThreadPool()->ReclaimRemote();
+}
+
+int64_t JobPool::GetHeapAllocationCount()
+{
+	return s_numHeapAllocations.load(std::memory_order_relaxed);
+}
+
+JobPool* JobPool::GetThreadPool()
+{
+	if (!s_threadPool.m_pool)
+	{
+		std::lock_guard<std::mutex> guard(s_idlePoolsLock);
+		if (!s_idlePools.empty())
+		{
+			s_threadPool.m_pool = s_idlePools.back();
+			s_idlePools.pop_back();
+		}
+		else
+		{
+			s_threadPool.m_pool = new JobPool();
+		}
+	}
+	return s_threadPool.m_pool;
+}
+
+void JobPool::ReleaseThreadPool(JobPool* pool)
+{
+	std::lock_guard<std::mutex> guard(s_idlePoolsLock);
+	s_idlePools.push_back(pool);
+}
+
+void* JobPool::AllocateBlock()
+{
+	if (!m_freeBlocks)
+		ReclaimRemote();
+	if (!m_freeBlocks)
+		AllocateSlab();
+
+	Block* block = m_freeBlocks;
+	m_freeBlocks = block->m_next;
+	return (unsigned char*)block + BLOCK_HEADER_SIZE;
+}
+
+void JobPool::FreeBlock(Block* block)
+{
+	if (s_threadPool.m_pool == this)
+	{
+		block->m_next = m_freeBlocks;
+		m_freeBlocks = block;
+		return;
+	}
+
+	// freed on another thread, hand it back to the owner
+	Block* head = m_remoteFreeBlocks.load(std::memory_order_relaxed);
+	do
+	{
+		block->m_next = head;
+	} while (!m_remoteFreeBlocks.compare_exchange_weak(head, block, std::memory_order_release, std::memory_order_relaxed));
+}
+
+void JobPool::AllocateSlab()
+{
+	s_numHeapAllocations++;
+	unsigned char* slab = (unsigned char*) ::operator new(BLOCK_STRIDE * BLOCKS_PER_SLAB);
+	m_slabs.push_back(slab);
+
+	for (int i = BLOCKS_PER_SLAB - 1; i >= 0; i--)
+	{
+		Block* block = (Block*)(slab + BLOCK_STRIDE * i);
+		block->m_owner = this;
+		block->m_next = m_freeBlocks;
+		m_freeBlocks = block;
+	}
+}
+
+void JobPool::ReclaimRemote()
+{
+	// only the owner pops, and it takes the whole list, so there is no ABA
+	Block* remote = m_remoteFreeBlocks.exchange(nullptr, std::memory_order_acquire);
+	while (remote)
+	{
+		Block* next = remote->m_next;
+		remote->m_next = m_freeBlocks;
+		m_freeBlocks = remote;
+		remote = next;
+	}
+}
+
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+// =============================================================================================
+// Fixed-size block allocator for short lived jobs. Every thread allocates from its own pool
+// without locking; blocks freed on another thread are pushed to the owner's remote list and
+// picked up again by the owner, so steady state queuing never reaches the system heap.
+// Pools outlive their threads: a pool is handed over to the next thread that needs one.
+// =============================================================================================
+class JobPool
+{
+public:
+	static constexpr size_t BLOCK_SIZE      = 240; // usable bytes per block, fits LambdaJob with debug iterators on; 256 byte stride
+	static constexpr int    BLOCKS_PER_SLAB = 64;
+
+	static void*   Allocate(size_t size);
+	static void    Free(void* memory);
+	static void    Reclaim(); // take back blocks freed by other threads, called by the owner every frame
+
+	static int64_t GetHeapAllocationCount(); // slabs and oversized blocks requested from the system heap so far
+
+private:
+	struct Block
+	{
+		JobPool*     m_owner;
+		Block*       m_next;
+	};
+
+	JobPool() = default;
+	~JobPool() = default;
+
+	static JobPool* GetThreadPool();
+	static void     ReleaseThreadPool(JobPool* pool);
+
+	void*   AllocateBlock();
+	void    FreeBlock(Block* block);
+	void    AllocateSlab();
+	void    ReclaimRemote();
+
+private:
+	static constexpr size_t BLOCK_HEADER_SIZE = 16; // keeps the payload 16 byte aligned
+	static constexpr size_t BLOCK_STRIDE      = BLOCK_HEADER_SIZE + BLOCK_SIZE;
+
+	Block*                     m_freeBlocks = nullptr; // owner only
+	alignas(64) std::atomic<Block*> m_remoteFreeBlocks = nullptr; // pushed by any thread, popped all at once by the owner
+	std::vector<unsigned char*> m_slabs;
+
+	static std::atomic<int64_t> s_numHeapAllocations;
+
+	friend struct JobPoolThreadHolder;
+};
+
@@ -0,0 +1,343 @@
+#include "Engine/Core/JobSystemBenchmark.hpp"
+
+#include "Engine/Core/CpuTopology.hpp"
+#include "Engine/Core/DevConsole.hpp"
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/JobSystem.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Core/Time.hpp"
+#include "Engine/Core/VertexUtils.hpp"
+#include "Engine/Core/Vertex_PCU.hpp"
+#include "Engine/Math/Mat4x4.hpp"
+#include "Engine/Math/MathUtils.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+
+// =================================================================================
+// =================================================================================
+static void BenchmarkPrint(const std::string& text)
+{
+	DebuggerPrintf("[JobSystemBenchmark] %s\n", text.c_str());
+	if (g_theConsole)
+		g_theConsole->AddLine(DevConsole::LOG_INFO, text);
+}
+
+
+// =================================================================================
+// A tiny unit of work, roughly the size of a per-entity update
+// =================================================================================
+static uint32_t BenchmarkWork(uint32_t value)
+{
+	for (int i = 0; i < 256; i++)
+		value = value * 1664525u + 1013904223u;
+	return value;
+}
+
+
+// =================================================================================
+// =================================================================================
+class BenchmarkJob : public Job
+{
+public:
+	BenchmarkJob(JobSystem* system, std::atomic_int* remaining, int children)
+		: m_system(system)
+		, m_remaining(remaining)
+		, m_children(children)
+	{
+	}
+
+private:
+	virtual void Execute() override
+	{
+		// spawn from inside the worker, these go to the local queue and get stolen
+		for (int i = 0; i < m_children; i++)
+			m_system->QueueJob(new BenchmarkJob(m_system, m_remaining, 0));
+
+		m_result = BenchmarkWork((uint32_t)m_id);
+
+		(*m_remaining)--;
+	}
+
+	virtual void OnFinished() override
+	{
+	}
+
+private:
+	JobSystem*          m_system;
+	std::atomic_int*    m_remaining;
+	int                 m_children;
+	volatile uint32_t   m_result = 0;
+};
+
+
+// =================================================================================
+// =================================================================================
+static double RunScalingPass(int workers, int numJobs, int childrenPerRoot)
+{
+	JobSystemConfig config;
+	config.m_workers = workers;
+	JobSystem system(config);
+	system.Startup();
+
+	int numRoots = numJobs / (childrenPerRoot + 1);
+	std::atomic_int remaining = numRoots * (childrenPerRoot + 1);
+	int total = remaining;
+
+	double startTime = GetCurrentTimeSeconds();
+	for (int i = 0; i < numRoots; i++)
+		system.QueueJob(new BenchmarkJob(&system, &remaining, childrenPerRoot));
+
+	while (remaining > 0)
+		std::this_thread::yield();
+	double elapsed = GetCurrentTimeSeconds() - startTime;
+
+	system.Shutdown();
+	return elapsed > 0.0 ? (double)total / elapsed : 0.0;
+}
+
+void JobSystemBenchmark_Scaling(int maxWorkers, int numJobs)
+{
+	BenchmarkPrint(Stringf("Scaling: %d jobs, 1 to %d workers", numJobs, maxWorkers));
+
+	double baseFlat = 0.0;
+	double baseFanOut = 0.0;
+	for (int workers = 1; workers <= maxWorkers; workers++)
+	{
+		double flat = RunScalingPass(workers, numJobs, 0);    // all jobs go through the injection queue
+		double fanOut = RunScalingPass(workers, numJobs, 63); // most jobs are queued from workers and stolen
+
+		if (workers == 1)
+		{
+			baseFlat = flat;
+			baseFanOut = fanOut;
+		}
+
+		BenchmarkPrint(Stringf("  workers=%-2d  flat: %10.0f jobs/s (x%.2f)  fan-out: %10.0f jobs/s (x%.2f)",
+			workers, flat, baseFlat > 0.0 ? flat / baseFlat : 0.0, fanOut, baseFanOut > 0.0 ? fanOut / baseFanOut : 0.0));
+	}
+}
+
+void JobSystemBenchmark_ParallelFor(int workers, int numVerts)
+{
+	constexpr int NUM_PASSES = 20;
+
+	BenchmarkPrint(Stringf("ParallelFor: TransformVertexArray on %d verts, %d workers + caller", numVerts, workers));
+
+	JobSystemConfig config;
+	config.m_workers = workers;
+	JobSystem system(config);
+	system.Startup();
+
+	Mat4x4 matrix = Mat4x4::CreateTranslation3D(Vec3(1.f, 2.f, 3.f));
+	matrix.AppendZRotation(30.f);
+	matrix.AppendScaleUniform3D(1.5f);
+
+	VertexList verts(numVerts, Vertex_PCU(Vec3(1.f, 1.f, 1.f), Rgba8::WHITE, Vec2()));
+
+	// serial reference
+	double startTime = GetCurrentTimeSeconds();
+	for (int pass = 0; pass < NUM_PASSES; pass++)
+		TransformVertexArray(matrix, verts);
+	double serial = (GetCurrentTimeSeconds() - startTime) / NUM_PASSES;
+	BenchmarkPrint(Stringf("  serial                 %8.3f ms", serial * 1000.0));
+
+	for (int grainSize : { 256, 1024, 4096, 16384 })
+	{
+		startTime = GetCurrentTimeSeconds();
+		for (int pass = 0; pass < NUM_PASSES; pass++)
+		{
+			JobHandle handle = system.ParallelFor(IntRange(0, numVerts - 1), grainSize, [&](int index)
+				{
+					verts[index].m_position = matrix.TransformPosition3D(verts[index].m_position);
+				});
+			system.Wait(handle);
+		}
+		double parallel = (GetCurrentTimeSeconds() - startTime) / NUM_PASSES;
+		BenchmarkPrint(Stringf("  parallel grain=%-6d  %8.3f ms (x%.2f)", grainSize, parallel * 1000.0, parallel > 0.0 ? serial / parallel : 0.0));
+	}
+
+	// reduce, max x extent of the transformed mesh
+	startTime = GetCurrentTimeSeconds();
+	float serialMax = 0.f;
+	for (int pass = 0; pass < NUM_PASSES; pass++)
+		for (const Vertex_PCU& vert : verts)
+			serialMax = Max(serialMax, vert.m_position.x);
+	serial = (GetCurrentTimeSeconds() - startTime) / NUM_PASSES;
+
+	startTime = GetCurrentTimeSeconds();
+	float parallelMax = 0.f;
+	for (int pass = 0; pass < NUM_PASSES; pass++)
+	{
+		auto result = system.ParallelReduce(IntRange(0, numVerts - 1), 4096, 0.f,
+			[&](int index) { return verts[index].m_position.x; },
+			[](float a, float b) { return Max(a, b); });
+		system.Wait(result);
+		parallelMax = result->GetResult();
+	}
+	double parallel = (GetCurrentTimeSeconds() - startTime) / NUM_PASSES;
+	BenchmarkPrint(Stringf("  reduce serial %8.3f ms, parallel %8.3f ms (x%.2f)%s", serial * 1000.0, parallel * 1000.0,
+		parallel > 0.0 ? serial / parallel : 0.0, serialMax == parallelMax ? "" : " MISMATCH"));
+
+	system.Shutdown();
+}
+
+void JobSystemBenchmark_LambdaJobs(int workers, int numJobs)
+{
+	constexpr int NUM_ROUNDS = 4;
+
+	BenchmarkPrint(Stringf("LambdaJobs: %d jobs per round, %d workers", numJobs, workers));
+
+	JobSystemConfig config;
+	config.m_workers = workers;
+	JobSystem system(config);
+	system.Startup();
+
+	std::atomic_int remaining = 0;
+	std::atomic<uint32_t> sink = 0;
+
+	// heap allocated subclass, finished up on this thread
+	double startTime = GetCurrentTimeSeconds();
+	for (int round = 0; round < NUM_ROUNDS; round++)
+	{
+		remaining = numJobs;
+		for (int i = 0; i < numJobs; i++)
+			system.QueueJob(new BenchmarkJob(&system, &remaining, 0));
+		while (remaining > 0)
+			std::this_thread::yield();
+		system.FinishUpJobs();
+	}
+	double heapJobs = (GetCurrentTimeSeconds() - startTime) / NUM_ROUNDS;
+
+	// pooled lambdas; the first round warms the pools up, later rounds should not touch the heap
+	double lambdaJobs = 0.0;
+	int64_t heapAllocations = 0;
+	for (int round = 0; round <= NUM_ROUNDS; round++)
+	{
+		system.BeginFrame();
+		int64_t allocationsBefore = JobPool::GetHeapAllocationCount();
+		startTime = GetCurrentTimeSeconds();
+
+		remaining = numJobs;
+		for (int i = 0; i < numJobs; i++)
+		{
+			system.QueueLambda([&remaining, &sink, i]()
+				{
+					sink.store(BenchmarkWork((uint32_t)i), std::memory_order_relaxed);
+					remaining--;
+				});
+		}
+		while (remaining > 0)
+			std::this_thread::yield();
+
+		if (round > 0)
+		{
+			lambdaJobs += GetCurrentTimeSeconds() - startTime;
+			heapAllocations += JobPool::GetHeapAllocationCount() - allocationsBefore;
+		}
+		system.EndFrame();
+	}
+	lambdaJobs /= NUM_ROUNDS;
+
+	BenchmarkPrint(Stringf("  new Job      %8.3f ms per round", heapJobs * 1000.0));
+	BenchmarkPrint(Stringf("  LambdaJob    %8.3f ms per round (x%.2f), %lld heap allocations after warm up",
+		lambdaJobs * 1000.0, lambdaJobs > 0.0 ? heapJobs / lambdaJobs : 0.0, (long long)heapAllocations));
+
+	system.Shutdown();
+}
+
+void JobSystemBenchmark_WakeLatency(int workers, int numSamples)
+{
+	BenchmarkPrint(Stringf("WakeLatency: queue to execute start, %d samples, %d workers", numSamples, workers));
+
+	JobSystemConfig config;
+	config.m_workers = workers;
+	JobSystem system(config);
+	system.Startup();
+
+	const char* policyNames[] = { "spin", "adaptive", "park" };
+	for (JobSleepPolicy policy : { JobSleepPolicy::SPIN, JobSleepPolicy::ADAPTIVE, JobSleepPolicy::PARK })
+	{
+		system.SetSleepPolicy(policy);
+
+		std::vector<double> latencies;
+		latencies.reserve(numSamples);
+		for (int sample = 0; sample < numSamples; sample++)
+		{
+			// let the workers go idle, like between two bursts of frame work
+			std::this_thread::sleep_for(std::chrono::microseconds(200));
+
+			std::atomic<double> startedAt = 0.0;
+			double queuedAt = GetCurrentTimeSeconds();
+			system.QueueLambda([&startedAt]() { startedAt = GetCurrentTimeSeconds(); });
+			while (startedAt == 0.0)
+				std::this_thread::yield();
+			latencies.push_back(startedAt - queuedAt);
+		}
+
+		std::sort(latencies.begin(), latencies.end());
+		double median = latencies[latencies.size() / 2];
+		double p99 = latencies[(latencies.size() * 99) / 100];
+		BenchmarkPrint(Stringf("  %-8s  median %8.2f us  p99 %8.2f us  max %8.2f us", policyNames[(int)policy],
+			median * 1000000.0, p99 * 1000000.0, latencies.back() * 1000000.0));
+	}
+
+	system.Shutdown();
+}
+
+void JobSystemBenchmark_Trace(int numEvents)
+{
+	BenchmarkPrint(Stringf("Trace: recording cost over %d events", numEvents));
+
+	// the recording done around every job: two tick reads and one ring buffer write
+	JobTraceBuffer buffer(16384);
+	double startTime = GetCurrentTimeSeconds();
+	for (int i = 0; i < numEvents; i++)
+	{
+		JobTraceEvent event;
+		event.m_jobId = i;
+		event.m_beginTick = JobTrace::GetTicks();
+		event.m_endTick = JobTrace::GetTicks();
+		buffer.Record(event);
+	}
+	double elapsed = GetCurrentTimeSeconds() - startTime;
+
+	// tick reads alone, they are much slower under some hypervisors
+	uint64_t sum = 0;
+	startTime = GetCurrentTimeSeconds();
+	for (int i = 0; i < numEvents; i++)
+		sum += JobTrace::GetTicks() + JobTrace::GetTicks();
+	double ticksElapsed = GetCurrentTimeSeconds() - startTime;
+
+	BenchmarkPrint(Stringf("  %.2f ns per event, %.2f ns of it reading ticks", elapsed * 1000000000.0 / (double)numEvents,
+		ticksElapsed * 1000000000.0 / (double)numEvents));
+	if (sum == 0)
+		BenchmarkPrint("  cpu ticks did not advance, trace timestamps are unusable");
+}
+
+bool Command_JobSystemBenchmark(EventArgs& args)
+{
+	std::string test = args.GetValue("test", "all");
+	int workers = atoi(args.GetValue("workers", "0").c_str());
+	int jobs = atoi(args.GetValue("jobs", "100000").c_str());
+	int verts = atoi(args.GetValue("verts", "100000").c_str());
+	int samples = atoi(args.GetValue("samples", "1000").c_str());
+
+	if (workers <= 0)
+		workers = CpuTopology::Get().GetNumPhysicalCores();
+
+	if (test == "all" || test == "scaling")
+		JobSystemBenchmark_Scaling(workers, jobs);
+	if (test == "all" || test == "parallelfor")
+		JobSystemBenchmark_ParallelFor(workers - 1, verts);
+	if (test == "all" || test == "lambda")
+		JobSystemBenchmark_LambdaJobs(workers, jobs);
+	if (test == "all" || test == "trace")
+		JobSystemBenchmark_Trace(jobs * 10);
+	if (test == "all" || test == "latency")
+		JobSystemBenchmark_WakeLatency(workers, samples > 0 ? samples : 1);
+	return true;
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include "Engine/Core/EventSystem.hpp"
+
+
+// =================================================================================
+// Micro benchmarks for the JobSystem. Each benchmark spins up its own JobSystem
+// instances so it can run next to the game's job system. Results go to the
+// DevConsole (if any) and the debugger output.
+//
+// Console: JobSystemBenchmark test=all workers=8 jobs=100000 verts=100000 samples=1000
+// =================================================================================
+void JobSystemBenchmark_Scaling(int maxWorkers, int numJobs);
+void JobSystemBenchmark_ParallelFor(int workers, int numVerts);
+void JobSystemBenchmark_LambdaJobs(int workers, int numJobs);
+void JobSystemBenchmark_WakeLatency(int workers, int numSamples);
+void JobSystemBenchmark_Trace(int numEvents);
+
+bool Command_JobSystemBenchmark(EventArgs& args);
@@ -1,5 +1,14 @@
 #pragma once
 
+// =================================================================================
+// What an idle compute worker does while waiting for jobs
+enum class JobSleepPolicy
+{
+	SPIN,       // never sleeps, lowest start latency, burns the core
+	ADAPTIVE,   // spins for m_spinCount checks, then parks
+	PARK,       // parks right away, no cpu used while idle
+};
+
 struct JobSystemConfig
 {
 public:
@@ -7,6 +16,15 @@ public:
 	~JobSystemConfig();
 
 public:
-	int m_workers = 3; // default for a 4-core
+	int m_workers = -1; // compute workers, -1 for one per physical core except the main thread's
+	int m_ioWorkers = 1; // workers for JobLane::IO, blocking file and network jobs
+	bool m_pinWorkers = false; // pin each compute worker to its own physical core
+	bool m_numaLocalQueues = true; // jobs given a NUMA node (Job::SetNumaNode) prefer that node's workers; needs m_pinWorkers
+	int m_spinCount = 4000; // checks of the queue counters before an ADAPTIVE worker parks
+	JobSleepPolicy m_frameSleepPolicy = JobSleepPolicy::ADAPTIVE; // between BeginFrame and EndFrame
+	JobSleepPolicy m_idleSleepPolicy = JobSleepPolicy::PARK; // between EndFrame and the next BeginFrame
+	bool m_logJobEvents = false; // print every queue/execute/finish, too slow for many small jobs
+	bool m_traceJobs = true; // record job timings for JobTraceDump, a few ns per job
+	int m_traceCapacity = 16384; // events kept per worker
 };
 
@@ -0,0 +1,58 @@
+#include "Engine/Core/JobTrace.hpp"
+
+
+// =============================================================================================
+// =============================================================================================
+JobTraceBuffer::JobTraceBuffer(int capacity)
+{
+	// capacity must be power of two for masking
+	uint64_t powerOfTwo = 64;
+	while (powerOfTwo < (uint64_t)capacity)
+		powerOfTwo <<= 1;
+
+	m_capacity = powerOfTwo;
+	m_mask = powerOfTwo - 1;
+	m_slots.reset(new Slot[powerOfTwo]);
+}
+
+void JobTraceBuffer::Collect(uint64_t sinceTick, std::vector<JobTraceEvent>& outEvents) const
+{
+	constexpr uint64_t OVERWRITE_MARGIN = 32; // slots the writer may reach while we copy
+
+	uint64_t end = m_writeIndex.load(std::memory_order_acquire);
+	uint64_t begin = end > m_capacity - OVERWRITE_MARGIN ? end - (m_capacity - OVERWRITE_MARGIN) : 0;
+
+	size_t firstCollected = outEvents.size();
+	std::vector<uint64_t> indices;
+	for (uint64_t index = begin; index < end; index++)
+	{
+		const Slot& slot = m_slots[index & m_mask];
+
+		JobTraceEvent event;
+		event.m_queuedTick = slot.m_queuedTick.load(std::memory_order_relaxed);
+		event.m_beginTick = slot.m_beginTick.load(std::memory_order_relaxed);
+		event.m_endTick = slot.m_endTick.load(std::memory_order_relaxed);
+		event.m_jobId = slot.m_jobId.load(std::memory_order_relaxed);
+		event.m_jobType = slot.m_jobType.load(std::memory_order_relaxed);
+		if (event.m_endTick < sinceTick)
+			continue;
+
+		outEvents.push_back(event);
+		indices.push_back(index);
+	}
+
+	// drop whatever the writer lapped meanwhile, those slots may hold a mix of two events. That includes
+	// index written - m_capacity: its slot is the one Record may be storing event #written into right now
+	std::atomic_thread_fence(std::memory_order_acquire);
+	uint64_t written = m_writeIndex.load(std::memory_order_relaxed);
+	uint64_t oldestIntact = written >= m_capacity ? written - m_capacity + 1 : 0;
+
+	size_t keep = firstCollected;
+	for (size_t i = 0; i < indices.size(); i++)
+	{
+		if (indices[i] >= oldestIntact)
+			outEvents[keep++] = outEvents[firstCollected + i];
+	}
+	outEvents.resize(keep);
+}
+
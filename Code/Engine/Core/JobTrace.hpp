@@ -0,0 +1,84 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+
+
+// =============================================================================================
+// One executed job, timestamps in cpu ticks (see JobTrace::GetTicks)
+// =============================================================================================
+struct JobTraceEvent
+{
+	uint64_t     m_queuedTick = 0; // when it became ready to run
+	uint64_t     m_beginTick = 0;
+	uint64_t     m_endTick = 0;
+	int          m_jobId = 0;
+	int          m_jobType = 0;
+};
+
+
+// =============================================================================================
+// Fixed-size ring of the most recent events. One thread records, any thread may collect; events
+// overwritten while collecting are dropped. Recording is a handful of plain stores.
+// =============================================================================================
+class JobTraceBuffer
+{
+public:
+	JobTraceBuffer(int capacity);
+
+	JobTraceBuffer(const JobTraceBuffer&) = delete;
+	void operator=(const JobTraceBuffer&) = delete;
+
+	void    Record(const JobTraceEvent& event);
+	void    Collect(uint64_t sinceTick, std::vector<JobTraceEvent>& outEvents) const; // events ending at or after sinceTick
+
+private:
+	struct Slot
+	{
+		std::atomic<uint64_t>    m_queuedTick;
+		std::atomic<uint64_t>    m_beginTick;
+		std::atomic<uint64_t>    m_endTick;
+		std::atomic<int>         m_jobId;
+		std::atomic<int>         m_jobType;
+	};
+
+private:
+	uint64_t                     m_capacity;
+	uint64_t                     m_mask;
+	std::unique_ptr<Slot[]>      m_slots;
+	std::atomic<uint64_t>        m_writeIndex = 0;
+};
+
+
+// =============================================================================================
+// =============================================================================================
+namespace JobTrace
+{
+	inline uint64_t GetTicks()   { return __rdtsc(); }
+}
+
+
+// =============================================================================================
+// =================================   INLINE FUNCTIONS   ======================================
+// =============================================================================================
+inline void JobTraceBuffer::Record(const JobTraceEvent& event)
+{
+	// single writer, relaxed stores are plain movs; the index release publishes the slot
+	uint64_t index = m_writeIndex.load(std::memory_order_relaxed);
+	Slot& slot = m_slots[index & m_mask];
+	slot.m_queuedTick.store(event.m_queuedTick, std::memory_order_relaxed);
+	slot.m_beginTick.store(event.m_beginTick, std::memory_order_relaxed);
+	slot.m_endTick.store(event.m_endTick, std::memory_order_relaxed);
+	slot.m_jobId.store(event.m_jobId, std::memory_order_relaxed);
+	slot.m_jobType.store(event.m_jobType, std::memory_order_relaxed);
+	m_writeIndex.store(index + 1, std::memory_order_release);
+}
+
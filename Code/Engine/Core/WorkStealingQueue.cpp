@@ -0,0 +1,111 @@
+#include "Engine/Core/WorkStealingQueue.hpp"
+
+
+WorkStealingQueue::RingBuffer::RingBuffer(int64_t capacity)
+	: m_capacity(capacity)
+	, m_mask(capacity - 1)
+	, m_slots(new std::atomic<Job*>[capacity])
+{
+}
+
+WorkStealingQueue::RingBuffer::~RingBuffer()
+{
+	delete[] m_slots;
+}
+
+WorkStealingQueue::WorkStealingQueue(int64_t initialCapacity /*= 256*/)
+{
+	// capacity must be power of two for masking
+	int64_t capacity = 1;
+	while (capacity < initialCapacity)
+		capacity <<= 1;
+
+	m_ring.store(new RingBuffer(capacity), std::memory_order_relaxed);
+}
+
+WorkStealingQueue::~WorkStealingQueue()
+{
+	delete m_ring.load(std::memory_order_relaxed);
+	for (RingBuffer* ring : m_retiredRings)
+		delete ring;
+}
+
+void WorkStealingQueue::Push(Job* job)
+{
+	int64_t bottom = m_bottom.load(std::memory_order_relaxed);
+	int64_t top = m_top.load(std::memory_order_acquire);
+	RingBuffer* ring = m_ring.load(std::memory_order_relaxed);
+
+	if (bottom - top > ring->m_capacity - 1)
+		ring = Grow(ring, bottom, top);
+
+	ring->Put(bottom, job);
+	std::atomic_thread_fence(std::memory_order_release);
+	m_bottom.store(bottom + 1, std::memory_order_relaxed);
+}
+
+Job* WorkStealingQueue::Pop()
+{
+	int64_t bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+	RingBuffer* ring = m_ring.load(std::memory_order_relaxed);
+	m_bottom.store(bottom, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	int64_t top = m_top.load(std::memory_order_relaxed);
+
+	if (top > bottom)
+	{
+		// empty
+		m_bottom.store(bottom + 1, std::memory_order_relaxed);
+		return nullptr;
+	}
+
+	Job* job = ring->Get(bottom);
+	if (top == bottom)
+	{
+		// last element, race against thieves
+		if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+			job = nullptr;
+		m_bottom.store(bottom + 1, std::memory_order_relaxed);
+	}
+	return job;
+}
+
+Job* WorkStealingQueue::Steal()
+{
+	int64_t top = m_top.load(std::memory_order_acquire);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	int64_t bottom = m_bottom.load(std::memory_order_acquire);
+
+	if (top >= bottom)
+		return nullptr;
+
+	RingBuffer* ring = m_ring.load(std::memory_order_acquire);
+	Job* job = ring->Get(top);
+	if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+		return nullptr; // lost the race, let caller try elsewhere
+	return job;
+}
+
+bool WorkStealingQueue::IsEmpty() const
+{
+	return Size() <= 0;
+}
+
+int64_t WorkStealingQueue::Size() const
+{
+	int64_t bottom = m_bottom.load(std::memory_order_relaxed);
+	int64_t top = m_top.load(std::memory_order_relaxed);
+	return bottom - top;
+}
+
+WorkStealingQueue::RingBuffer* WorkStealingQueue::Grow(RingBuffer* ring, int64_t bottom, int64_t top)
+{
+	RingBuffer* grown = new RingBuffer(ring->m_capacity * 2);
+	for (int64_t i = top; i < bottom; i++)
+		grown->Put(i, ring->Get(i));
+
+	m_retiredRings.push_back(ring);
+	m_ring.store(grown, std::memory_order_release);
+	return grown;
+}
+
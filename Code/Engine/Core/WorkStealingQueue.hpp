@@ -0,0 +1,55 @@
+#pragma once
+
+#include <atomic>
+#include <vector>
+#include <cstdint>
+
+
+// =============================================================================================
+// =============================================================================================
+class Job;
+
+
+// =============================================================================================
+// Lock-free Chase-Lev deque. The owning worker pushes and pops at the bottom (LIFO), any other
+// thread may steal from the top (FIFO). Only the owner may call Push/Pop.
+// =============================================================================================
+class WorkStealingQueue
+{
+public:
+	WorkStealingQueue(int64_t initialCapacity = 256);
+	~WorkStealingQueue();
+
+	WorkStealingQueue(const WorkStealingQueue&) = delete;
+	void operator=(const WorkStealingQueue&) = delete;
+
+	void       Push(Job* job);   // owner only
+	Job*       Pop();            // owner only
+	Job*       Steal();          // any thread
+
+	bool       IsEmpty() const;
+	int64_t    Size() const;
+
+private:
+	struct RingBuffer
+	{
+		RingBuffer(int64_t capacity);
+		~RingBuffer();
+
+		Job*        Get(int64_t index) const            { return m_slots[index & m_mask].load(std::memory_order_relaxed); }
+		void        Put(int64_t index, Job* job)        { m_slots[index & m_mask].store(job, std::memory_order_relaxed); }
+
+		int64_t             m_capacity;
+		int64_t             m_mask;
+		std::atomic<Job*>*  m_slots;
+	};
+
+	RingBuffer* Grow(RingBuffer* ring, int64_t bottom, int64_t top);
+
+private:
+	alignas(64) std::atomic<int64_t>      m_top        = 0;
+	alignas(64) std::atomic<int64_t>      m_bottom     = 0;
+	alignas(64) std::atomic<RingBuffer*>  m_ring       = nullptr;
+	std::vector<RingBuffer*>              m_retiredRings; // kept alive until destruction, thieves may still read them
+};
+
@@ -1043,14 +1043,19 @@ void SessionClient::NetworkTickClient()
     while (m_bufferRecv.ReadMessage(packet))
         HandleMessage(packet);
 
-    for (const auto& pkt : m_queue)
-        m_bufferSend.WriteMessage(pkt);
-    m_queue.clear();
+    for (size_t i = 0; i < m_numQueued; i++)
+        m_bufferSend.WriteMessage(m_queue[i]);
+    m_numQueued = 0;
 }
 
 void SessionClient::SendToServer(Packet& pkt)
 {
-    m_queue.push_back(pkt);
+    // slots are reused, copying into one keeps the buffer it had
+    if (m_numQueued < m_queue.size())
+        m_queue[m_numQueued] = pkt;
+    else
+        m_queue.push_back(pkt);
+    m_numQueued++;
 }
 
 void SessionClient::HandleMessage(Packet& pkt)
@@ -1079,8 +1084,8 @@ void SessionClient::RunNetworkThread(const char* host, const char* port, int ret
         {
             const std::lock_guard<std::recursive_mutex> lockSend(m_bufferSend.m_lock);
             const std::lock_guard<std::recursive_mutex> lockRecv(m_bufferRecv.m_lock);
-            m_bufferSend.m_data.clear();
-            m_bufferRecv.m_data.clear();
+            m_bufferSend.m_data.Reset();
+            m_bufferRecv.m_data.Reset();
         }
 
         Connect(host, port, true);
@@ -1413,9 +1418,9 @@ void SessionServer::Client::NetworkTickConnection(SessionServer* server)
     while (m_bufferRecv.ReadMessage(packet))
         server->HandleMessage(this, packet);
 
-    for (const auto& pkt : m_queue)
-        m_bufferSend.WriteMessage(pkt);
-    m_queue.clear();
+    for (size_t i = 0; i < m_numQueued; i++)
+        m_bufferSend.WriteMessage(m_queue[i]);
+    m_numQueued = 0;
 }
 
 const std::string& SessionServer::Client::GetEndpointAddr() const
@@ -1430,7 +1435,12 @@ void SessionServer::Client::Disconnect()
 
 void SessionServer::Client::Send(Packet& pkt)
 {
-    m_queue.push_back(pkt);
+    // slots are reused, copying into one keeps the buffer it had
+    if (m_numQueued < m_queue.size())
+        m_queue[m_numQueued] = pkt;
+    else
+        m_queue.push_back(pkt);
+    m_numQueued++;
 }
 
 void SessionServer::Client::RunNetworkThread()
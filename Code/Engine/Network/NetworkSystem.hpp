@@ -203,6 +203,7 @@ public:
     PacketBuffer m_bufferRecv;
 
     std::vector<Packet> m_queue;
+    size_t m_numQueued = 0; // m_queue keeps its packets past this for reuse
     std::map<int, PacketHandler> m_handlers;
 
     SessionClient();
@@ -251,6 +252,7 @@ public:
         PacketBuffer m_bufferRecv;
 
         std::vector<Packet> m_queue;
+        size_t m_numQueued = 0; // m_queue keeps its packets past this for reuse
 
     private:
         Client();
@@ -1,5 +1,8 @@
 #include "Engine/Network/Packet.hpp"
 
+#include "Engine/Core/ByteBufferPool.hpp"
+#include "Engine/Core/ByteCompression.hpp"
+#include "Engine/Core/Checksum.hpp"
 #include "Engine/Core/ErrorWarningAssert.hpp"
 #include "Engine/Core/StringUtils.hpp"
 #include "Engine/Math/MathUtils.hpp"
@@ -38,33 +41,73 @@ Packet::~Packet()
 {
 }
 
+ByteBufferView Packet::GetPayload() const
+{
+	return ByteBufferView(m_buffer.data(), m_buffer.size());
+}
+
 
 bool PacketBuffer::ReadMessage(Packet& packet)
 {
 	std::lock_guard<std::recursive_mutex> guard(m_lock);
 
-	size_t pktSize = sizeof(PKT_HEADER);
-	if (!IsReadable(sizeof(PKT_HEADER)))
-		return false;
-	PKT_HEADER header;
-	std::copy(m_data.begin(), m_data.begin() + sizeof(PKT_HEADER), (char*) &header);
-	header.type  = NTOHS(header.type);
-	header.flags = NTOHS(header.flags);
-	header.size  = NTOHL(header.size);
-
-	pktSize += header.size;
-	if (!IsReadable(pktSize))
-		return false;
-
-    Read(header);
-    header.type = NTOHS(header.type);
-    header.flags = NTOHS(header.flags);
-    header.size = NTOHL(header.size);
-
-	packet.m_id = header.type;
-	packet.m_buffer.resize(header.size);
-	ReadBytes(header.size, packet.m_buffer.data());
-	return true;
+	// dropped packets loop back for the next one, a run of bad packets mustn't grow the stack
+	for (;;)
+	{
+		size_t pktSize = sizeof(PKT_HEADER);
+		if (!IsReadable(sizeof(PKT_HEADER)))
+			return false;
+		PKT_HEADER header;
+		memcpy(&header, &m_data.data()[m_data.m_readIdx], sizeof(PKT_HEADER));
+		header.type  = NTOHS(header.type);
+		header.flags = NTOHS(header.flags);
+		header.size  = NTOHL(header.size);
+
+		pktSize += header.size;
+		if (!IsReadable(pktSize))
+			return false;
+
+		Read(header);
+		header.type = NTOHS(header.type);
+		header.flags = NTOHS(header.flags);
+		header.size = NTOHL(header.size);
+
+		packet.m_id = header.type;
+		packet.m_buffer.resize(header.size);
+		ReadBytes(header.size, packet.m_buffer.data());
+
+		if (header.flags & PKT_FLAG_CHECKSUM)
+		{
+			// checked on the bytes as sent, before anything looks inside them
+			uint32_t crc = 0;
+			bool intact = header.size >= sizeof(crc);
+			if (intact)
+			{
+				header.size -= sizeof(crc);
+				memcpy(&crc, &packet.m_buffer[header.size], sizeof(crc));
+				intact = NTOHL(crc) == Crc32c(packet.m_buffer.data(), header.size);
+			}
+			if (!intact)
+			{
+				DebuggerPrintf("PacketBuffer: packet %u failed its checksum, dropped\n", header.type);
+				continue;
+			}
+			packet.m_buffer.resize(header.size);
+		}
+
+		if (header.flags & PKT_FLAG_COMPRESSED)
+		{
+			ByteBufferLease payload = ByteBufferPool::GetShared().Acquire();
+			if (!DecompressBuffer(packet.GetPayload(), *payload))
+			{
+				// drop it and carry on with the next one
+				DebuggerPrintf("PacketBuffer: corrupt compressed packet %u dropped\n", header.type);
+				continue;
+			}
+			packet.m_buffer.assign((const char*)payload->data(), (const char*)payload->data() + payload->m_writeIdx);
+		}
+		return true;
+	}
 }
 
 void PacketBuffer::WriteMessage(const Packet& packet)
@@ -80,24 +123,49 @@ void PacketBuffer::WriteMessage(const Packet& packet)
 	PKT_HEADER header = {};
 	header.type = packet.m_id;
 	header.size = (int)packet.m_buffer.size();
+	const char* payload = packet.m_buffer.data();
+
+	ByteBufferLease compressed;
+	if (m_compressThreshold && packet.m_buffer.size() >= m_compressThreshold)
+	{
+		compressed = ByteBufferPool::GetShared().Acquire(packet.m_buffer.size());
+		CompressBuffer(packet.GetPayload(), *compressed);
+		if (compressed->m_writeIdx < packet.m_buffer.size())
+		{
+			header.flags |= PKT_FLAG_COMPRESSED;
+			header.size = (int)compressed->m_writeIdx;
+			payload = (const char*)compressed->data();
+		}
+	}
+
+	uint32_t payloadSize = header.size;
+	uint32_t crc = 0;
+	if (m_checksumPackets)
+	{
+		header.flags |= PKT_FLAG_CHECKSUM;
+		header.size += sizeof(crc);
+		crc = HTONL(Crc32c(payload, payloadSize));
+	}
 
 	Write(HTONS(header.type));
 	Write(HTONS(header.flags));
 	Write(HTONL(header.size));
-	WriteBytes(header.size, packet.m_buffer.data());
+	WriteBytes(payloadSize, payload);
+	if (header.flags & PKT_FLAG_CHECKSUM)
+		Write(crc);
 }
 
 bool PacketBuffer::IsReadable(size_t size)
 {
-	return m_data.size() >= size;
+	return m_data.GetReadableSize() >= size;
 }
 
 size_t PacketBuffer::ReadBytes(size_t size, char* data)
 {
 	std::lock_guard<std::recursive_mutex> guard(m_lock);
 
-	if (size > m_data.size())
-		size = m_data.size();
+	if (size > m_data.GetReadableSize())
+		size = m_data.GetReadableSize();
 
 	if (size == 0)
 		return 0;
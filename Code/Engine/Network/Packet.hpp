@@ -1,9 +1,9 @@
 // ================ BUFFER  UTILITIES SECTION =============== //
 #include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/ByteBuffer.hpp"
 
 #pragma once
 
-#include <deque>
 #include <vector>
 #include <string>
 #include <mutex>
@@ -22,6 +22,10 @@ public:
 	Packet(const Packet& copyFrom);
 	~Packet();
 
+	Packet& operator=(const Packet& copyFrom) = default; // reuses the buffer's capacity
+
+	ByteBufferView GetPayload() const; // parse in place, valid while the packet lives and isn't resized
+
 };
 
 class PacketBuffer
@@ -34,9 +38,15 @@ private:
 		uint32_t size;
 	};
 
+public:
+	static constexpr uint16_t PKT_FLAG_COMPRESSED = 1 << 0; // payload is a ByteCompression stream
+	static constexpr uint16_t PKT_FLAG_CHECKSUM   = 1 << 1; // payload is followed by its CRC32C, network order (size includes it)
+
 public:
 	std::recursive_mutex m_lock;
-	std::deque<char> m_data;
+	ByteBuffer m_data; // queued bytes from m_readIdx on; keeps its capacity, so steady traffic doesn't allocate
+	size_t m_compressThreshold = 0; // payloads at least this big go out compressed if that shrinks them, 0 never
+	bool m_checksumPackets = false; // outgoing packets carry a checksum; incoming ones are checked whenever they have one
 
 public:
 	size_t ReadBytes(size_t size, char* data);
@@ -49,19 +59,19 @@ private:
 	template<typename T>
 	void Write(size_t arrLen, const T* arrPtr)
 	{
-		const char* begin = (const char*) arrPtr;
-		const char* end   = (const char*) &arrPtr[arrLen];
-		m_data.insert(m_data.end(), begin, end);
+		m_data.Write(arrLen, arrPtr);
 	}
 
 	template<typename T>
 	void Read(size_t arrLen, T* arrPtr)
 	{
-		char* begin = (char*) arrPtr;
-		size_t dataSize = sizeof(T) * arrLen;
+		m_data.Read(arrLen, arrPtr);
 
-		std::copy(m_data.begin(), m_data.begin() + dataSize, begin);
-		m_data.erase(m_data.begin(), m_data.begin() + dataSize);
+		// move what's left to the front once the consumed part dominates, the buffer never creeps
+		if (m_data.GetReadableSize() == 0)
+			m_data.Reset();
+		else if (m_data.m_readIdx > m_data.GetReadableSize())
+			m_data.ShrinkBuffer();
 	}
 
 	template<typename T>